@@ -4,66 +4,25 @@
 //Matric No.: 23301291
 //Selection expenses for individual
 
+#include <charconv>
+#include <cstdio>
 #include <iostream>
 #include <iomanip>
 #include <string>
+#include <string_view>
 #include "SE_Individual.hpp"
+#include "../mapped_file.hpp"
+#include "../record_reader.hpp"
+#include "../relief_categories.hpp"
+#include "../relief_engine.hpp"
+#include "../report_buffer.hpp"
 
 using namespace std;
 
-// Maximum deductions for each expense category
-const int MaxDeductions[23] = {
-    9000,  // 1. Individual and dependent relatives
-    8000,  // 2. Expenses for parents (medical, dental, etc.)
-    6000,  // 3. Purchase of basic supporting equipment for disabled
-    6000,  // 4. Disabled individual
-    7000,  // 5. Education fees (self)
-    10000, // 6. Medical expenses (serious diseases, fertility, etc.)
-    1000,  // 7. Expenses (medical examination, COVID-19, mental health)
-    4000,  // 8. Expenses for child (intellectual disability, early intervention)
-    2500,  // 9. Lifestyle (books, computers, internet, courses)
-    1000,  // 10. Lifestyle (sports equipment, gym membership)
-    1000,  // 11. Breastfeeding equipment
-    3000,  // 12. Child care fees
-    8000,  // 13. Skim Simpanan Pendidikan Nasional
-    4000,  // 14. Husband/wife/alimony
-    5000,  // 15. Disabled husband/wife
-    2000,  // 16. Unmarried child under 18
-    2000,  // 17. Unmarried child 18+ (A-Level, diploma, etc.)
-    6000,  // 18. Disabled child
-    7000,  // 19. Life insurance and EPF
-    3000,  // 20. Deferred Annuity and PRS
-    3000,  // 21. Education and medical insurance
-    350,   // 22. SOCSO contribution
-    2500   // 23. Electric vehicle charging facilities
-};
-
-// Array of category descriptions
-const string categories[23] = {
-    "individual and dependent relatives",
-    "expenses for parents (medical, dental, etc.)",
-    "purchase of basic supporting equipment for disabled",
-    "disabled individual",
-    "education fees (self)",
-    "medical expenses (serious diseases, fertility, etc.)",
-    "expenses (medical examination, COVID-19, mental health)",
-    "expenses for child (intellectual disability, early intervention)",
-    "lifestyle (books, computers, internet, courses)",
-    "lifestyle (sports equipment, gym membership)",
-    "breastfeeding equipment",
-    "child care fees",
-    "Skim Simpanan Pendidikan Nasional",
-    "husband/wife/alimony",
-    "disabled husband/wife",
-    "unmarried child under 18",
-    "unmarried child 18+ (A-Level, diploma, etc.)",
-    "disabled child",
-    "life insurance and EPF",
-    "deferred annuity or PRS",
-    "education or medical insurance",
-    "SOCSO contributions",
-    "electric vehicle charging facilities"
-};
+// Maximum deductions and descriptions for the 23 categories are shared with
+// the tax calculator through relief_categories.hpp
+const int* const MaxDeductions = RELIEF_MAX_DEDUCTIONS;
+const string_view* const categories = RELIEF_CATEGORIES;
 
 // Function to handle the selection of expenses
 void selectionexpenses()
@@ -167,19 +126,36 @@ int getNumberInput(const string& prompt)
     }
 }
 
+// Function to check whether the questionnaire asks about a category
+// (eligibility, per-child amounts and caps live in relief_engine.hpp)
+bool isCategoryAsked(int category, ReliefProfile profile)
+{
+    return isReliefEligible(profile, category);
+}
+
+// Function to turn an answer into a deductible amount
+// (child reliefs are answered with a number of children)
+int deductibleForAnswer(int category, int answer, ReliefProfile profile)
+{
+    return capRelief(profile, category, answer);
+}
+
 // Function to handle questions for single individuals
 void AskQuestionForSingle(int dexpenses[])
 {
-    int categoriesForSingle[] = {0, 1, 2, 3, 4, 5, 6, 8, 9, 10, 12, 18, 19, 20, 21, 22}; // Categories for single
-    
-    for (int i : categoriesForSingle)
+    for (int i = 0; i < 23; i++)
     {
-        string category = categories[i]; // Get category description from the array
+        if (!isCategoryAsked(i, ReliefProfile::SINGLE))
+        {
+            continue;
+        }
+
+        string category(categories[i]); // Get category description from the array
 
         if (askQuestion("Do you have any expenses for " + category + "?"))
         {
             int expenses = getNumberInput("Enter the amount you spent on " + category + " (RM): ");
-            dexpenses[i] = min(expenses, MaxDeductions[i]);
+            dexpenses[i] = deductibleForAnswer(i, expenses, ReliefProfile::SINGLE);
             cout << "Your deductible amount for " << category << " is RM " << dexpenses[i] << ".\n";
         }
         else
@@ -194,33 +170,29 @@ void AskQuestionForMarried(int dexpenses[])
 {
     // Ask if the user has any children
     bool hasChildren = askQuestion("Do you have any children?");
+    ReliefProfile profile = reliefProfile(true, hasChildren);
 
     for (int i = 0; i < 23; i++)
     {
         // Skip child-related categories if the user has no children
-        if (!hasChildren && (i == 7 || i == 11 || i == 15 || i == 16 || i == 17))
+        if (!isCategoryAsked(i, profile))
         {
             continue; // Skip these categories
         }
 
-        string category = categories[i]; // Get category description from the array
+        string category(categories[i]); // Get category description from the array
 
         if (askQuestion("Do you have expenses for " + category + "?"))
         {
-            if (i == 15 || i == 16) // Categories depending on the number of children
+            if (i == 15 || i == 16 || i == 17) // Categories depending on the number of children
             {
                 int numChildren = getNumberInput("Enter the number of " + category + ": ");
-                dexpenses[i] = numChildren * 2000;
-            }
-            else if (i == 17) // Categories depending on the number of children
-            {
-                int numChildren = getNumberInput("Enter the number of " + category + ": ");
-                dexpenses[i] = numChildren * 6000;
+                dexpenses[i] = deductibleForAnswer(i, numChildren, profile);
             }
             else
             {
                 int expenses = getNumberInput("Please enter your expenses for " + category + " (RM): ");
-                dexpenses[i] = min(expenses, MaxDeductions[i]);
+                dexpenses[i] = deductibleForAnswer(i, expenses, profile);
             }
             cout << "Deductible amount: RM " << dexpenses[i] << ".\n";
         }
@@ -270,8 +242,235 @@ void displayDeductibleTable(int dexpenses[])
     cout << "+----+-------------------------------------------------------------------+---------------------+\n";
 }
 
-// Main function
-int main() {
+// ===================== ANSWER REPLAY =====================
+// Recorded answers, one relief form per line, in the order the questionnaire asks them:
+//   marital status (S, M or D); for M and D, Y or N for "Do you have any children?";
+//   then Y or N for every category asked, with the amount in RM (or the number of
+//   children) after each Y.
+// Answers are separated by spaces. Categories left unanswered at the end of a line
+// count as N. Blank lines and lines starting with '#' are skipped.
+// Example: "S Y 12000 N N N Y 3500" claims RM 9000 (capped) and RM 3500 for education fees.
+
+// Function to take the next answer from a recorded form
+bool nextAnswer(string_view& line, string_view& answer)
+{
+    size_t start = line.find_first_not_of(" \t");
+    if (start == string_view::npos)
+    {
+        line = string_view();
+        return false;
+    }
+    size_t end = line.find_first_of(" \t", start);
+    if (end == string_view::npos)
+    {
+        end = line.size();
+    }
+    answer = line.substr(start, end - start);
+    line.remove_prefix(end);
+    return true;
+}
+
+// Function to read one recorded form: the answers as given (capping is left
+// to the relief engine) and the profile that decides which categories count
+bool readReliefForm(string_view line, int answers[], ReliefProfile& profile, char& maritalstatus)
+{
+    string_view answer;
+    for (int i = 0; i < RELIEF_COLUMNS; i++)
+    {
+        answers[i] = 0;
+    }
+
+    if (!nextAnswer(line, answer) || answer.size() != 1 ||
+        (answer[0] != 'S' && answer[0] != 'M' && answer[0] != 'D'))
+    {
+        return false;
+    }
+    maritalstatus = answer[0];
+    bool married = maritalstatus != 'S';
+
+    bool hasChildren = false;
+    if (married && nextAnswer(line, answer))
+    {
+        if (answer != "Y" && answer != "N")
+        {
+            return false;
+        }
+        hasChildren = answer == "Y";
+    }
+    profile = reliefProfile(married, hasChildren);
+
+    for (int i = 0; i < 23; i++)
+    {
+        if (!isCategoryAsked(i, profile))
+        {
+            continue;
+        }
+        if (!nextAnswer(line, answer))
+        {
+            return true; // remaining categories not claimed
+        }
+        if (answer == "N")
+        {
+            continue;
+        }
+        if (answer != "Y" || !nextAnswer(line, answer))
+        {
+            return false;
+        }
+
+        const char* end = answer.data() + answer.size();
+        from_chars_result parsed = from_chars(answer.data(), end, answers[i]);
+        if (parsed.ec != errc() || parsed.ptr != end || answers[i] < 0)
+        {
+            return false;
+        }
+    }
+    return !nextAnswer(line, answer); // nothing may follow the last category
+}
+
+// Function to write the capped rows of a relief batch as CSV
+void writeReliefBatch(const ReliefBatch& batch, const vector<long>& lineNumbers, const string& maritalstatuses,
+                      ReportBuffer& out)
+{
+    for (size_t r = 0; r < batch.size(); r++)
+    {
+        out.appendInteger(lineNumbers[r]).append(',').append(maritalstatuses[r]).append(',')
+           .appendInteger(batch.total(r));
+        const int* capped = batch.cappedRow(r);
+        for (int i = 0; i < 23; i++)
+        {
+            out.append(',').appendInteger(capped[i]);
+        }
+        out.append('\n');
+    }
+}
+
+// Function to replay every form in 'text' and write one CSV row per form.
+// Forms are collected in blocks and capped together by the relief engine.
+int replayReliefForms(string_view text, ReportBuffer& out)
+{
+    const size_t BLOCK_SIZE = 4096;
+
+    out.append("line,marital_status,total_deductible");
+    for (int i = 0; i < 23; i++)
+    {
+        out.append(",relief_").appendInteger(i + 1);
+    }
+    out.append('\n');
+
+    LineReader reader(text);
+    string_view line;
+    ReliefBatch batch;
+    vector<long> lineNumbers;
+    string maritalstatuses;
+    int answers[RELIEF_COLUMNS];
+    int rejected = 0;
+    while (true)
+    {
+        bool more = reader.next(line);
+        if (!more || batch.size() == BLOCK_SIZE)
+        {
+            batch.calculate();
+            writeReliefBatch(batch, lineNumbers, maritalstatuses, out);
+            batch.clear();
+            lineNumbers.clear();
+            maritalstatuses.clear();
+        }
+        if (!more)
+        {
+            break;
+        }
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        ReliefProfile profile;
+        char maritalstatus;
+        if (!readReliefForm(line, answers, profile, maritalstatus))
+        {
+            cerr << "line " << reader.lineNumber() << ": answers do not match the questionnaire, form skipped.\n";
+            rejected++;
+            continue;
+        }
+        int* row = batch.addRow(profile);
+        for (int i = 0; i < RELIEF_COLUMNS; i++)
+        {
+            row[i] = answers[i];
+        }
+        lineNumbers.push_back(reader.lineNumber());
+        maritalstatuses.push_back(maritalstatus);
+    }
+    return rejected;
+}
+
+// Function to read all of standard input in large blocks
+string readAllInput()
+{
+    string text;
+    char block[1 << 16];
+    size_t count;
+    while ((count = fread(block, 1, sizeof(block), stdin)) > 0)
+    {
+        text.append(block, count);
+    }
+    return text;
+}
+
+// Main function (left out with -DSE_INDIVIDUAL_NO_MAIN when linked into the benchmarks)
+//   SE_Individual                                   interactive questionnaire
+//   SE_Individual --replay <answers.txt|-> [out.csv] replay recorded forms ('-' reads stdin)
+#ifndef SE_INDIVIDUAL_NO_MAIN
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--replay")
+    {
+        if (argc < 3)
+        {
+            cerr << "Usage: " << argv[0] << " --replay <answers.txt|-> [output.csv]\n";
+            return 1;
+        }
+
+        MappedFile file;
+        string input;
+        string_view text;
+        if (string(argv[2]) == "-")
+        {
+            input = readAllInput();
+            text = input;
+        }
+        else if (file.open(argv[2]))
+        {
+            text = file.text();
+        }
+        else
+        {
+            cerr << "Error opening " << argv[2] << " for reading.\n";
+            return 1;
+        }
+
+        ReportBuffer out;
+        if (argc > 3)
+        {
+            if (!out.open(argv[3]))
+            {
+                cerr << "Error opening " << argv[3] << " for writing.\n";
+                return 1;
+            }
+        }
+        else
+        {
+            out.attach(stdout);
+        }
+        int rejected = replayReliefForms(text, out);
+        if (!out.close())
+        {
+            cerr << "Error writing results.\n";
+            return 1;
+        }
+        return rejected == 0 ? 0 : 1;
+    }
+
     selectionexpenses();
     return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -1,4 +1,6 @@
 # include <string>
+# include <string_view>
+# include "../relief_engine.hpp"
 
 using namespace std;
 
@@ -7,6 +9,9 @@ bool askQuestion(const string& question);
 int getNumberInput(const string& prompt);
 void AskQuestionForSingle(int dexpenses[]);
 void AskQuestionForMarried(int dexpenses[]);
+bool isCategoryAsked(int category, ReliefProfile profile);
+int deductibleForAnswer(int category, int answer, ReliefProfile profile);
+bool readReliefForm(string_view line, int answers[], ReliefProfile& profile, char& maritalstatus);
 int calculateTotalDeductible(int dexpenses[], int size);
 void displayDeductibleTable(int dexpenses[]);
 void selectionexpenses();
\ No newline at end of file
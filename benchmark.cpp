@@ -0,0 +1,336 @@
+// Microbenchmarks for the tax calculation, report and relief paths.
+//
+// Build from the repository root:
+//   g++ -O2 -pthread -DSE_INDIVIDUAL_NO_MAIN benchmark.cpp "Selection Expenses V4/SE_Individual.cpp" -o benchmark
+// Run all benchmarks, or only those whose name contains 'filter':
+//   ./benchmark [filter]
+//
+// Each benchmark doubles its repetition count until one measurement takes
+// at least 0.2 s, then reports time per operation, throughput and heap
+// allocations per operation (counted by the operator new below).
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include "tax_calculator.hpp"
+#include "tax_kernel.hpp"
+#include "net_income.hpp"
+#include "relief_engine.hpp"
+#include "relief_optimizer.hpp"
+#include "report_buffer.hpp"
+#include "tax_cache.hpp"
+#include "Selection Expenses V4/SE_Individual.hpp"
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// ===================== ALLOCATION COUNTING =====================
+// These replace the global operators, so new/delete really are malloc/free.
+// GCC cannot tell once a delete is inlined and warns about the mismatch.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+static unsigned long long allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    ++allocationCount;
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+// Aligned forms, used by std::pmr::new_delete_resource(). The MSVC runtime
+// has no std::aligned_alloc, and its aligned blocks need _aligned_free.
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++allocationCount;
+    std::size_t align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+    void* memory = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+    void* memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept {
+#ifdef _WIN32
+    _aligned_free(memory);
+#else
+    std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(memory, alignment);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+// ===================== HARNESS =====================
+// Results are folded into this so the compiler cannot drop the work
+static volatile double benchmarkSink = 0;
+
+static const char* benchmarkFilter = nullptr;
+
+// Stream buffer that drops everything written to it
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override {
+        return c;
+    }
+};
+
+// Times body(), which performs 'opsPerCall' operations per call
+template <class Body>
+void runBenchmark(const std::string& name, std::size_t opsPerCall, Body body) {
+    if (benchmarkFilter != nullptr && name.find(benchmarkFilter) == std::string::npos) {
+        return;
+    }
+    body(); // warm up caches and one-time initialisation
+
+    unsigned long long calls = 1;
+    double seconds = 0;
+    unsigned long long allocations = 0;
+    while (true) {
+        unsigned long long allocationsBefore = allocationCount;
+        auto start = std::chrono::steady_clock::now();
+        for (unsigned long long i = 0; i < calls; i++) {
+            body();
+        }
+        auto stop = std::chrono::steady_clock::now();
+        seconds = std::chrono::duration<double>(stop - start).count();
+        allocations = allocationCount - allocationsBefore;
+        if (seconds >= 0.2) {
+            break;
+        }
+        calls *= 2;
+    }
+
+    double ops = static_cast<double>(calls) * static_cast<double>(opsPerCall);
+    std::cout << std::left << std::setw(52) << name << std::right << std::fixed
+              << std::setw(12) << std::setprecision(2) << seconds * 1e9 / ops
+              << std::setw(14) << std::setprecision(3) << ops / seconds / 1e6
+              << std::setw(14) << std::setprecision(2) << static_cast<double>(allocations) / ops << "\n";
+}
+
+// Deterministic spread of incomes from RM 0 to about RM 600,000
+std::vector<double> sampleIncomes(std::size_t count) {
+    std::vector<double> incomes(count);
+    unsigned state = 12345;
+    for (auto& income : incomes) {
+        state = state * 1103515245u + 12345u;
+        income = static_cast<double>((state >> 8) % 60000000) / 100;
+    }
+    return incomes;
+}
+
+// ===================== BENCHMARKS =====================
+void benchmarkBrackets() {
+    const std::size_t COUNT = 1024;
+    std::vector<double> incomes = sampleIncomes(COUNT);
+    std::vector<double> taxes(COUNT);
+
+    const AssessmentType types[3] = {AssessmentType::INDIVIDUAL, AssessmentType::JOINT,
+                                     AssessmentType::SOLE_PROPRIETOR};
+    for (AssessmentType type : types) {
+        runBenchmark(std::string("evaluateTax (") + assessmentTypeName(type) + ")", COUNT, [&] {
+            double total = 0;
+            for (double income : incomes) {
+                total += evaluateTax(type, income);
+            }
+            benchmarkSink = benchmarkSink + total;
+        });
+    }
+    for (AssessmentType type : types) {
+        runBenchmark(std::string("calculateTaxes kernel (") + assessmentTypeName(type) + ")", COUNT, [&] {
+            calculateTaxes(type, incomes.data(), taxes.data(), COUNT);
+            benchmarkSink = benchmarkSink + taxes[COUNT - 1];
+        });
+    }
+    runBenchmark("evaluateTaxSen (Individual)", COUNT, [&] {
+        Sen total = 0;
+        for (double income : incomes) {
+            total += evaluateTaxSen(AssessmentType::INDIVIDUAL, static_cast<Sen>(income * 100));
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(total);
+    });
+
+    // Whole-ringgit incomes so every lookup after the warm-up call hits
+    std::vector<Sen> bands(COUNT);
+    for (std::size_t i = 0; i < COUNT; i++) {
+        bands[i] = toSen(static_cast<double>(static_cast<long>(incomes[i])));
+    }
+    TaxCache cache(1 << 16);
+    installTaxCache(&cache);
+    runBenchmark("evaluateTaxSenCached (Individual, all hits)", COUNT, [&] {
+        Sen total = 0;
+        for (Sen income : bands) {
+            total += evaluateTaxSenCached(AssessmentType::INDIVIDUAL, income);
+        }
+        benchmarkSink = benchmarkSink + static_cast<double>(total);
+    });
+    installTaxCache(nullptr);
+}
+
+void benchmarkCalculator() {
+    const std::size_t expenseCounts[3] = {1, 10, 100};
+    for (std::size_t n : expenseCounts) {
+        runBenchmark("TaxCalculator build + calculateTax (" + std::to_string(n) + " expenses)", 1, [n] {
+            TaxCalculator calculator("Chin Yun Quan", "123456-34-4567", AssessmentType::INDIVIDUAL);
+            calculator.addIncomeSource("Salary", 345678);
+            for (std::size_t i = 0; i < n; i++) {
+                calculator.addExpense(ExpenseCategory::MEDICAL, "Checkup", 100 + static_cast<double>(i));
+            }
+            benchmarkSink = benchmarkSink + calculator.calculateTax();
+        });
+    }
+
+    TaxCalculator calculator("Chin Yun Quan", "123456-34-4567", AssessmentType::INDIVIDUAL);
+    calculator.addIncomeSource("Salary", 345678);
+    for (int i = 0; i < 10; i++) {
+        calculator.addExpense(ExpenseCategory::INSURANCE, "Life", 500);
+    }
+    double amount = 0;
+    runBenchmark("TaxCalculator updateExpense + calculateTax", 1, [&] {
+        amount = amount < 1000 ? amount + 1 : 0;
+        calculator.updateExpense(3, amount);
+        benchmarkSink = benchmarkSink + calculator.calculateTax();
+    });
+
+    // Report text is formatted into a buffer with no file attached
+    ReportBuffer report;
+    DateContext dates({2025, 1, 4});
+    runBenchmark("writeTaxSummary (null sink, 10 expenses)", 1, [&] {
+        report.clear();
+        calculator.writeTaxSummary(report, dates);
+        benchmarkSink = benchmarkSink + static_cast<double>(report.view().size());
+    });
+}
+
+void benchmarkHousehold() {
+    std::vector<Expense> expenses = {{ExpenseCategory::MEDICAL, "Checkup", 2000},
+                                     {ExpenseCategory::INSURANCE, "Life", 3000}};
+    std::vector<ReliefClaim> noReliefs;
+    std::vector<ReliefClaim> reliefs = {{1, 8000}, {15, 6000}, {13, 4000}};
+
+    runBenchmark("assessHousehold", 1, [&] {
+        HouseholdComparison result = assessHousehold("Ali", "1", 80000, "Siti", "2", 30000, expenses, noReliefs);
+        benchmarkSink = benchmarkSink + result.jointTax;
+    });
+    runBenchmark("assessHousehold (3 transferable reliefs)", 1, [&] {
+        HouseholdComparison result = assessHousehold("Ali", "1", 80000, "Siti", "2", 30000, expenses, reliefs);
+        benchmarkSink = benchmarkSink + result.totalOptimizedTax;
+    });
+    // The household batch path: one arena reused across records
+    alignas(std::max_align_t) char arenaBuffer[16384];
+    std::pmr::monotonic_buffer_resource arena(arenaBuffer, sizeof(arenaBuffer));
+    runBenchmark("assessHousehold (arena)", 1, [&] {
+        arena.release();
+        HouseholdComparison result = assessHousehold("Ali", "1", 80000, "Siti", "2", 30000, expenses, noReliefs,
+                                                     ArithmeticMode::FLOATING_POINT, &arena);
+        benchmarkSink = benchmarkSink + result.jointTax;
+    });
+    runBenchmark("optimizeReliefSplit (3 reliefs)", 1, [&] {
+        ReliefSplit split = optimizeReliefSplit(INDIVIDUAL_SCHEDULE, 75000, 25000, reliefs.data(), reliefs.size());
+        benchmarkSink = benchmarkSink + split.totalTax;
+    });
+
+#ifdef _WIN32
+    const std::string NULL_FILE = "NUL";
+#else
+    const std::string NULL_FILE = "/dev/null";
+#endif
+    // compareAssessments reports to std::cout; silence it while timing
+    NullBuffer discard;
+    runBenchmark("compareAssessments (to null file)", 1, [&] {
+        std::streambuf* console = std::cout.rdbuf(&discard);
+        compareAssessments("Ali", "1", 80000, "Siti", "2", 30000, expenses, noReliefs, NULL_FILE);
+        std::cout.rdbuf(console);
+    });
+}
+
+void benchmarkInverse() {
+    std::vector<double> targets = sampleIncomes(1024);
+    runBenchmark("requiredGrossIncome (Individual)", targets.size(), [&] {
+        double total = 0;
+        for (double target : targets) {
+            total += requiredGrossIncome(AssessmentType::INDIVIDUAL, target, 9000);
+        }
+        benchmarkSink = benchmarkSink + total;
+    });
+}
+
+// Selection Expenses V4: cap all 23 relief categories and total them
+void benchmarkReliefs() {
+    int spent[23];
+    for (int i = 0; i < 23; i++) {
+        spent[i] = 1000 * (i % 7) + 250 * i;
+    }
+    spent[15] = spent[16] = spent[17] = 2; // per-child reliefs are answered with a number of children
+    int dexpenses[23];
+    runBenchmark("V4 deductibleForAnswer x23 + calculateTotalDeductible", 1, [&] {
+        for (int i = 0; i < 23; i++) {
+            dexpenses[i] = deductibleForAnswer(i, spent[i], ReliefProfile::MARRIED_WITH_CHILDREN);
+        }
+        benchmarkSink = benchmarkSink + calculateTotalDeductible(dexpenses, 23);
+    });
+
+    const std::size_t ROWS = 1024;
+    ReliefBatch batch;
+    for (std::size_t r = 0; r < ROWS; r++) {
+        std::int32_t* row = batch.addRow(static_cast<ReliefProfile>(r % RELIEF_PROFILE_COUNT));
+        for (int i = 0; i < 23; i++) {
+            row[i] = i >= 15 && i <= 17 ? static_cast<std::int32_t>(r % 4) : spent[i];
+        }
+    }
+    runBenchmark("ReliefBatch capReliefs (per row)", ROWS, [&] {
+        batch.calculate();
+        benchmarkSink = benchmarkSink + batch.total(ROWS - 1);
+    });
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        benchmarkFilter = argv[1];
+    }
+    std::cout << std::left << std::setw(52) << "Benchmark" << std::right << std::setw(12) << "ns/op"
+              << std::setw(14) << "Mops/s" << std::setw(14) << "allocs/op" << "\n";
+    std::cout << std::string(92, '-') << "\n";
+
+    benchmarkBrackets();
+    benchmarkCalculator();
+    benchmarkHousehold();
+    benchmarkInverse();
+    benchmarkReliefs();
+    return 0;
+}
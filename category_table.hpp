@@ -0,0 +1,107 @@
+#ifndef CATEGORY_TABLE_HPP
+#define CATEGORY_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Compile-time perfect hash from a fixed list of names to their index.
+// The constructor searches for a seed under which every name lands in its
+// own slot, so a lookup is one hash, one table read and one string compare.
+template <std::size_t N, std::size_t SLOTS>
+class PerfectHashIndex {
+public:
+    static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+    static_assert(N < SLOTS && N < 255, "Too many names for the slot table");
+
+    constexpr PerfectHashIndex(const std::string_view (&names)[N]) : names(names), seed(0), slots{} {
+        while (!trySeed(seed)) {
+            ++seed;
+        }
+    }
+
+    // Index of 'name' in the original list, or -1
+    constexpr int find(std::string_view name) const {
+        std::uint8_t slot = slots[hash(seed, name) & (SLOTS - 1)];
+        if (slot == EMPTY || names[slot] != name) {
+            return -1;
+        }
+        return slot;
+    }
+
+private:
+    static constexpr std::uint8_t EMPTY = 0xFF;
+
+    const std::string_view (&names)[N];
+    std::uint32_t seed;
+    std::uint8_t slots[SLOTS];
+
+    // FNV-1a mixed with a seed
+    static constexpr std::uint32_t hash(std::uint32_t seed, std::string_view text) {
+        std::uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (char c : text) {
+            h ^= static_cast<std::uint8_t>(c);
+            h *= 16777619u;
+        }
+        return h ^ (h >> 15);
+    }
+
+    constexpr bool trySeed(std::uint32_t candidate) {
+        for (std::size_t i = 0; i < SLOTS; i++) {
+            slots[i] = EMPTY;
+        }
+        for (std::size_t i = 0; i < N; i++) {
+            std::uint32_t slot = hash(candidate, names[i]) & (SLOTS - 1);
+            if (slots[slot] != EMPTY) {
+                return false;
+            }
+            slots[slot] = static_cast<std::uint8_t>(i);
+        }
+        return true;
+    }
+};
+
+// Expense categories accepted by TaxCalculator, stored per expense as a one-byte ID
+enum class ExpenseCategory : std::uint8_t {
+    MEDICAL,
+    INSURANCE,
+    EDUCATION,
+    DONATIONS,
+    PARENTAL_CARE,
+    SAVINGS,
+    LIFESTYLE,
+    BOOKS_AND_EQUIPMENT,
+    UNKNOWN = 0xFF
+};
+
+// List of allowed expense categories as per Malaysian tax laws (indexed by ExpenseCategory)
+constexpr std::string_view ALLOWED_CATEGORIES[] = {
+    "Medical",
+    "Insurance",
+    "Education",
+    "Donations",
+    "Parental Care",
+    "Savings",
+    "Lifestyle",
+    "Books and Equipment"
+};
+
+constexpr PerfectHashIndex<8, 32> EXPENSE_CATEGORY_INDEX(ALLOWED_CATEGORIES);
+
+constexpr ExpenseCategory findExpenseCategory(std::string_view name) {
+    int index = EXPENSE_CATEGORY_INDEX.find(name);
+    return index < 0 ? ExpenseCategory::UNKNOWN : static_cast<ExpenseCategory>(index);
+}
+
+constexpr std::string_view expenseCategoryName(ExpenseCategory category) {
+    return category == ExpenseCategory::UNKNOWN ? std::string_view() : ALLOWED_CATEGORIES[static_cast<int>(category)];
+}
+
+constexpr bool isCategoryAllowed(std::string_view category) {
+    return findExpenseCategory(category) != ExpenseCategory::UNKNOWN;
+}
+
+static_assert(findExpenseCategory("Books and Equipment") == ExpenseCategory::BOOKS_AND_EQUIPMENT, "Category hash broken");
+static_assert(findExpenseCategory("Gym") == ExpenseCategory::UNKNOWN, "Category hash broken");
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef CHUNK_PIPELINE_HPP
+#define CHUNK_PIPELINE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "instrumentation.hpp"
+#include "record_reader.hpp"
+#include "ring_queue.hpp"
+
+// Reader -> compute -> writer pipeline over the lines of a text, used by the
+// batch modes. Chunks of lines move between the stages through the rings in
+// ring_queue.hpp and reach the writer in input order.
+
+// Data lines of one chunk and their 1-based line numbers in the text
+struct PipelineChunk {
+    std::size_t sequence = 0;
+    std::vector<std::string_view> lines;
+    std::vector<long> lineNumbers;
+};
+
+// Reads up to 'maxLines' data lines, skipping blank lines and a leading header
+inline bool readLineBlock(LineReader& reader, std::size_t maxLines, std::vector<std::string_view>& lines,
+                   std::vector<long>& lineNumbers) {
+    lines.clear();
+    lineNumbers.clear();
+    std::string_view line;
+    while (lines.size() < maxLines && reader.next(line)) {
+        if (line.empty() || (reader.lineNumber() == 1 && line.substr(0, 4) == "name")) {
+            continue;
+        }
+        lines.push_back(line);
+        lineNumbers.push_back(reader.lineNumber());
+    }
+    return !lines.empty();
+}
+
+// Streams the data lines of 'text' through three pipeline stages joined by
+// bounded lock-free rings, so reading, calculation and writing overlap:
+//   reader   splits the text into chunks of 'chunkSize' lines
+//   compute  'threads' workers, each calling compute(chunk, scratch) on one chunk at a time
+//   writer   this thread, which calls write(chunk) on finished chunks in input order
+// A fixed set of Chunks (derived from PipelineChunk, constructed from 'options')
+// circulates between the stages; when the writer falls behind, the reader
+// runs out of free chunks and waits, so memory stays bounded. 'options' has
+// 'threads' (0 = one per hardware thread) and 'chunkSize' members, and each
+// worker keeps one Chunk::Scratch for the whole run.
+template <class Chunk, class Options, class Compute, class Write>
+void runChunkPipeline(std::string_view text, const Options& options, Compute compute, Write write) {
+    unsigned computeThreads = options.threads > 0 ? options.threads : std::thread::hardware_concurrency();
+    if (computeThreads == 0) {
+        computeThreads = 1;
+    }
+    const std::size_t chunkCount = 4 * static_cast<std::size_t>(computeThreads) + 2;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    SpscRing<Chunk*> freeChunks(chunkCount);                   // writer -> reader
+    MpmcRing<Chunk*> parsedChunks(chunkCount + computeThreads); // reader -> compute; nullptr ends a worker
+    MpmcRing<Chunk*> doneChunks(chunkCount + computeThreads);   // compute -> writer; nullptr: a worker finished
+    for (std::size_t i = 0; i < chunkCount; i++) {
+        chunks.emplace_back(new Chunk(options));
+        freeChunks.push(chunks.back().get());
+    }
+
+    std::thread reader([&] {
+        LineReader lineReader(text);
+        for (std::size_t sequence = 0;; sequence++) {
+            Chunk* chunk = freeChunks.pop();
+            if (!readLineBlock(lineReader, options.chunkSize, chunk->lines, chunk->lineNumbers)) {
+                break;
+            }
+            chunk->sequence = sequence;
+            parsedChunks.push(chunk);
+        }
+        for (unsigned i = 0; i < computeThreads; i++) {
+            parsedChunks.push(nullptr);
+        }
+    });
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < computeThreads; t++) {
+        workers.emplace_back([&] {
+            typename Chunk::Scratch scratch;
+            while (Chunk* chunk = parsedChunks.pop()) {
+                compute(*chunk, scratch);
+                doneChunks.push(chunk);
+            }
+            doneChunks.push(nullptr);
+        });
+    }
+
+    // At most chunkCount chunks are in flight, so sequence % chunkCount is a free reorder slot
+    std::vector<Chunk*> reorder(chunkCount, nullptr);
+    std::size_t nextSequence = 0;
+    unsigned finishedWorkers = 0;
+    while (finishedWorkers < computeThreads) {
+        Chunk* finished = doneChunks.pop();
+        if (finished == nullptr) {
+            ++finishedWorkers;
+            continue;
+        }
+        reorder[finished->sequence % chunkCount] = finished;
+        while (Chunk* chunk = reorder[nextSequence % chunkCount]) {
+            TAX_STAGE_TIMER(Stage::REPORT_WRITING);
+            reorder[nextSequence % chunkCount] = nullptr;
+            write(*chunk);
+            freeChunks.push(chunk);
+            ++nextSequence;
+        }
+    }
+    reader.join();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef DATE_CONTEXT_HPP
+#define DATE_CONTEXT_HPP
+
+#include <ctime>
+#include <string_view>
+#include "tax_schedule.hpp"
+
+// Calendar date handling for tax summaries without repeated time()/localtime()
+// calls. Dates are converted to civil day numbers (days since 1970-01-01),
+// so differences are plain subtraction and no shared static tm buffer is used.
+
+struct CivilDate {
+    int year;
+    int month; // 1-12
+    int day;   // 1-31
+};
+
+// Days since 1970-01-01 in the proleptic Gregorian calendar
+constexpr long daysFromCivil(CivilDate date) {
+    long year = date.month <= 2 ? date.year - 1 : date.year;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153 * (date.month + (date.month > 2 ? -3 : 9)) + 2) / 5 + date.day - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static_assert(daysFromCivil({1970, 1, 1}) == 0, "Civil day conversion broken");
+static_assert(daysFromCivil({2025, 4, 30}) - daysFromCivil({2025, 1, 4}) == 116, "Civil day conversion broken");
+
+constexpr bool isLeapYear(int year) {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+constexpr int daysInMonth(int year, int month) {
+    return month == 2 ? (isLeapYear(year) ? 29 : 28) : (month == 4 || month == 6 || month == 9 || month == 11) ? 30 : 31;
+}
+
+static_assert(daysInMonth(2024, 2) == 29 && daysInMonth(2023, 2) == 28 && daysInMonth(1900, 2) == 28 &&
+              daysInMonth(2000, 2) == 29 && daysInMonth(2023, 4) == 30, "Month lengths broken");
+
+// Parses "YYYY-MM-DD", rejecting days the month does not have
+inline bool parseCivilDate(std::string_view text, CivilDate& date) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') {
+        return false;
+    }
+    int values[3] = {0, 0, 0};
+    const int starts[3] = {0, 5, 8};
+    const int lengths[3] = {4, 2, 2};
+    for (int field = 0; field < 3; field++) {
+        for (int i = 0; i < lengths[field]; i++) {
+            char c = text[static_cast<std::size_t>(starts[field] + i)];
+            if (c < '0' || c > '9') {
+                return false;
+            }
+            values[field] = values[field] * 10 + (c - '0');
+        }
+    }
+    date = {values[0], values[1], values[2]};
+    return date.month >= 1 && date.month <= 12 && date.day >= 1 && date.day <= daysInMonth(date.year, date.month);
+}
+
+// Writes "YYYY-MM-DD" into 'text' (at least 10 characters)
+inline void formatCivilDate(CivilDate date, char* text) {
+    int parts[3] = {date.year, date.month, date.day};
+    int widths[3] = {4, 2, 2};
+    int position = 0;
+    for (int field = 0; field < 3; field++) {
+        for (int i = widths[field] - 1; i >= 0; i--) {
+            text[position + i] = static_cast<char>('0' + parts[field] % 10);
+            parts[field] /= 10;
+        }
+        position += widths[field];
+        if (field < 2) {
+            text[position++] = '-';
+        }
+    }
+}
+
+// Filing dates for one run, computed once.
+// Returns for an assessment year are due in the following year: individual
+// and joint returns on 30 April, sole proprietors (business income) on 30 June.
+class DateContext {
+public:
+    explicit DateContext(CivilDate today, int assessmentYear = ACTIVE_ASSESSMENT_YEAR)
+        : today(today), todayDay(daysFromCivil(today)) {
+        formatCivilDate(today, todayText);
+        deadlines[0] = {assessmentYear + 1, 4, 30};
+        deadlines[1] = {assessmentYear + 1, 6, 30};
+        for (int i = 0; i < 2; i++) {
+            deadlineDays[i] = daysFromCivil(deadlines[i]);
+            formatCivilDate(deadlines[i], deadlineTexts[i]);
+        }
+    }
+
+    // Context for the local date on this machine, read once (thread-safe)
+    static const DateContext& current() {
+        static const DateContext context(localToday());
+        return context;
+    }
+
+    static CivilDate localToday() {
+        std::time_t now = std::time(nullptr);
+        std::tm local = {};
+#ifdef _WIN32
+        localtime_s(&local, &now);
+#else
+        localtime_r(&now, &local);
+#endif
+        return {local.tm_year + 1900, local.tm_mon + 1, local.tm_mday};
+    }
+
+    CivilDate currentDate() const {
+        return today;
+    }
+
+    long currentDay() const {
+        return todayDay;
+    }
+
+    std::string_view currentDateText() const {
+        return std::string_view(todayText, 10);
+    }
+
+    CivilDate deadline(AssessmentType type) const {
+        return deadlines[deadlineIndex(type)];
+    }
+
+    std::string_view deadlineText(AssessmentType type) const {
+        return std::string_view(deadlineTexts[deadlineIndex(type)], 10);
+    }
+
+    // Days from today until the deadline (negative once it has passed)
+    long daysRemaining(AssessmentType type) const {
+        return deadlineDays[deadlineIndex(type)] - todayDay;
+    }
+
+    // Days a return filed on 'filingDay' (a civil day number) is late; 0 if on time
+    long daysLate(AssessmentType type, long filingDay) const {
+        long late = filingDay - deadlineDays[deadlineIndex(type)];
+        return late > 0 ? late : 0;
+    }
+
+private:
+    CivilDate today;
+    long todayDay;
+    char todayText[10];
+    CivilDate deadlines[2];
+    long deadlineDays[2];
+    char deadlineTexts[2][10];
+
+    static int deadlineIndex(AssessmentType type) {
+        return type == AssessmentType::SOLE_PROPRIETOR ? 1 : 0;
+    }
+};
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef FIXED_POINT_HPP
+#define FIXED_POINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include "tax_schedule.hpp"
+
+// Integer arithmetic in sen (1/100 ringgit) for bit-reproducible results.
+// Amounts are rounded to the sen once, when they enter the calculation;
+// rates are held in basis points (1/10000), and each bracket product is
+// rounded half away from zero back to the sen.
+
+using Sen = std::int64_t;
+
+enum class ArithmeticMode { FLOATING_POINT, FIXED_POINT };
+
+// Largest magnitude of an amount in sen (RM 10^13). toSen() and addSen()
+// saturate at it, and SenSchedule::evaluate() clamps its argument to it, so
+// every bracket product stays inside int64 however many amounts a record
+// sums (see productsFit below).
+const Sen SEN_LIMIT = 1000000000000000;
+
+// Ringgit to sen, rounding half away from zero. Out-of-range amounts
+// saturate at +/-SEN_LIMIT and NaN becomes 0, instead of overflowing the cast.
+constexpr Sen toSen(double ringgit) {
+    double scaled = ringgit * 100;
+    if (!(scaled > -SEN_LIMIT && scaled < SEN_LIMIT)) {
+        return scaled != scaled ? 0 : scaled < 0 ? -SEN_LIMIT : SEN_LIMIT;
+    }
+    return static_cast<Sen>(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+}
+
+static_assert(toSen(1e300) == SEN_LIMIT && toSen(-1e300) == -SEN_LIMIT && toSen(-0.005) == -1,
+              "toSen range guard broken");
+
+// a + b saturating at +/-SEN_LIMIT, for a and b within +/-SEN_LIMIT
+constexpr Sen addSen(Sen a, Sen b) {
+    Sen sum = a + b;
+    return sum > SEN_LIMIT ? SEN_LIMIT : sum < -SEN_LIMIT ? -SEN_LIMIT : sum;
+}
+
+static_assert(addSen(SEN_LIMIT, SEN_LIMIT) == SEN_LIMIT && addSen(-SEN_LIMIT, -1) == -SEN_LIMIT &&
+              addSen(SEN_LIMIT, -1) == SEN_LIMIT - 1, "addSen saturation broken");
+
+constexpr double toRinggit(Sen sen) {
+    return static_cast<double>(sen) / 100;
+}
+
+// numerator / denominator rounded half away from zero (denominator > 0)
+constexpr Sen divideRounded(Sen numerator, Sen denominator) {
+    return numerator < 0 ? -((-numerator + denominator / 2) / denominator)
+                         : (numerator + denominator / 2) / denominator;
+}
+
+const Sen BASIS_POINTS = 10000;
+
+// BracketSchedule with thresholds and bases in sen and rates in basis points
+template <std::size_t N>
+struct SenSchedule {
+    Sen thresholds[N];
+    Sen bases[N];
+    Sen rates[N];
+
+    constexpr Sen evaluate(Sen taxableIncome) const {
+        taxableIncome = taxableIncome > SEN_LIMIT ? SEN_LIMIT : taxableIncome < -SEN_LIMIT ? -SEN_LIMIT : taxableIncome;
+        std::size_t k = 0;
+        for (std::size_t i = 1; i < N; i++) {
+            k += taxableIncome > thresholds[i];
+        }
+        return bases[k] + divideRounded((taxableIncome - thresholds[k]) * rates[k], BASIS_POINTS);
+    }
+};
+
+template <std::size_t N>
+constexpr SenSchedule<N> toSenSchedule(const BracketSchedule<N>& schedule) {
+    SenSchedule<N> converted = {};
+    for (std::size_t i = 0; i < N; i++) {
+        converted.thresholds[i] = toSen(schedule.thresholds[i]);
+        converted.bases[i] = toSen(schedule.bases[i]);
+        double basisPoints = schedule.rates[i] * BASIS_POINTS;
+        converted.rates[i] = static_cast<Sen>(basisPoints + 0.5);
+    }
+    return converted;
+}
+
+// True when converting to sen lost nothing (every rate is a whole basis point)
+template <std::size_t N>
+constexpr bool convertsExactly(const BracketSchedule<N>& schedule, const SenSchedule<N>& converted) {
+    for (std::size_t i = 0; i < N; i++) {
+        double difference = schedule.rates[i] * BASIS_POINTS - static_cast<double>(converted.rates[i]);
+        if (difference > 1e-6 || difference < -1e-6) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// True when (income - threshold) * rate cannot overflow for any income the
+// evaluation lets through (|income| <= SEN_LIMIT)
+template <std::size_t N>
+constexpr bool productsFit(const SenSchedule<N>& schedule) {
+    for (std::size_t i = 0; i < N; i++) {
+        Sen threshold = schedule.thresholds[i] < 0 ? -schedule.thresholds[i] : schedule.thresholds[i];
+        if (schedule.rates[i] < 0 || threshold > SEN_LIMIT ||
+            (schedule.rates[i] > 0 && 2 * SEN_LIMIT > INT64_MAX / schedule.rates[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+namespace taxyear2023 {
+
+constexpr SenSchedule<8> INDIVIDUAL_SEN = toSenSchedule(INDIVIDUAL);
+constexpr SenSchedule<7> JOINT_SEN = toSenSchedule(JOINT);
+constexpr SenSchedule<4> SOLE_PROPRIETOR_SEN = toSenSchedule(SOLE_PROPRIETOR);
+
+static_assert(convertsExactly(INDIVIDUAL, INDIVIDUAL_SEN), "2023 individual rates are not whole basis points");
+static_assert(convertsExactly(JOINT, JOINT_SEN), "2023 joint rates are not whole basis points");
+static_assert(convertsExactly(SOLE_PROPRIETOR, SOLE_PROPRIETOR_SEN), "2023 sole proprietor rates are not whole basis points");
+static_assert(productsFit(INDIVIDUAL_SEN) && productsFit(JOINT_SEN) && productsFit(SOLE_PROPRIETOR_SEN),
+              "2023 bracket products may overflow int64");
+
+} // namespace taxyear2023
+
+constexpr Sen evaluateTaxSen(AssessmentType type, Sen taxableIncome) {
+    switch (type) {
+        case AssessmentType::JOINT:
+            return taxyear2023::JOINT_SEN.evaluate(taxableIncome);
+        case AssessmentType::SOLE_PROPRIETOR:
+            return taxyear2023::SOLE_PROPRIETOR_SEN.evaluate(taxableIncome);
+        default:
+            return taxyear2023::INDIVIDUAL_SEN.evaluate(taxableIncome);
+    }
+}
+
+static_assert(evaluateTaxSen(AssessmentType::INDIVIDUAL, 33888900) == 7178892, "Sen kernel broken");
+
+// Array form of evaluateTaxSen. The loop has no data-dependent branches,
+// so it is bit-identical on every thread and machine.
+inline void calculateTaxesSen(AssessmentType type, const Sen* taxableIncomes, Sen* taxes, std::size_t count) {
+    switch (type) {
+        case AssessmentType::JOINT:
+            for (std::size_t i = 0; i < count; i++) {
+                taxes[i] = taxyear2023::JOINT_SEN.evaluate(taxableIncomes[i]);
+            }
+            break;
+        case AssessmentType::SOLE_PROPRIETOR:
+            for (std::size_t i = 0; i < count; i++) {
+                taxes[i] = taxyear2023::SOLE_PROPRIETOR_SEN.evaluate(taxableIncomes[i]);
+            }
+            break;
+        default:
+            for (std::size_t i = 0; i < count; i++) {
+                taxes[i] = taxyear2023::INDIVIDUAL_SEN.evaluate(taxableIncomes[i]);
+            }
+            break;
+    }
+}
+
+#endif
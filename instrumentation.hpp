@@ -0,0 +1,202 @@
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "report_buffer.hpp"
+
+// Opt-in call counters and stage timers for the assessment hot path.
+// Build with -DTAX_INSTRUMENTATION to enable them; otherwise the
+// TAX_STAGE_TIMER macro expands to nothing and the counters stay zero.
+// Counters are relaxed atomics, one cache line per stage, so pool threads
+// can record concurrently. Timers sit at stage boundaries (a chunk of lines
+// parsed, an aggregation or bracket pass over a batch, a block of rows
+// written), never around O(1) accessors, so the timer itself stays small
+// against what it measures.
+// Stages may nest (a household comparison includes the bracket evaluations
+// it triggers), so their times are not meant to be summed.
+
+enum class Stage : int {
+    PARSING,
+    INCOME_AGGREGATION,
+    DEDUCTION_AGGREGATION,
+    BRACKET_EVALUATION,
+    RELIEF_CAPPING,
+    DATE_HANDLING,
+    HOUSEHOLD_COMPARISON,
+    REPORT_WRITING
+};
+
+const int STAGE_COUNT = 8;
+
+#ifdef TAX_INSTRUMENTATION
+constexpr bool INSTRUMENTATION_ENABLED = true;
+#else
+constexpr bool INSTRUMENTATION_ENABLED = false;
+#endif
+
+inline const char* stageName(Stage stage) {
+    switch (stage) {
+        case Stage::PARSING:
+            return "parsing";
+        case Stage::INCOME_AGGREGATION:
+            return "income aggregation";
+        case Stage::DEDUCTION_AGGREGATION:
+            return "deduction aggregation";
+        case Stage::BRACKET_EVALUATION:
+            return "bracket evaluation";
+        case Stage::RELIEF_CAPPING:
+            return "relief capping";
+        case Stage::DATE_HANDLING:
+            return "date handling";
+        case Stage::HOUSEHOLD_COMPARISON:
+            return "household comparison";
+        case Stage::REPORT_WRITING:
+            return "report writing";
+    }
+    return "";
+}
+
+struct StageStats {
+    std::uint64_t calls;
+    std::uint64_t nanoseconds;
+};
+
+struct InstrumentationSnapshot {
+    StageStats stages[STAGE_COUNT];
+
+    const StageStats& operator[](Stage stage) const {
+        return stages[static_cast<int>(stage)];
+    }
+};
+
+namespace instrumentation {
+
+struct alignas(64) StageCounters {
+    std::atomic<std::uint64_t> calls{0};
+    std::atomic<std::uint64_t> nanoseconds{0};
+};
+
+inline StageCounters* counters() {
+    static StageCounters table[STAGE_COUNT];
+    return table;
+}
+
+inline void record(Stage stage, std::uint64_t nanoseconds) {
+    StageCounters& counter = counters()[static_cast<int>(stage)];
+    counter.calls.fetch_add(1, std::memory_order_relaxed);
+    counter.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+}
+
+// Records one call of 'stage' and the time until the end of the scope
+class StageTimer {
+public:
+    explicit StageTimer(Stage stage) : stage(stage), start(std::chrono::steady_clock::now()) {}
+
+    ~StageTimer() {
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        record(stage, static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+} // namespace instrumentation
+
+#ifdef TAX_INSTRUMENTATION
+#define TAX_STAGE_TIMER_CONCAT(a, b) a##b
+#define TAX_STAGE_TIMER_NAME(line) TAX_STAGE_TIMER_CONCAT(stageTimer, line)
+#define TAX_STAGE_TIMER(stage) instrumentation::StageTimer TAX_STAGE_TIMER_NAME(__LINE__)(stage)
+#else
+#define TAX_STAGE_TIMER(stage) ((void)0)
+#endif
+
+// Current totals for every stage
+inline InstrumentationSnapshot instrumentationSnapshot() {
+    InstrumentationSnapshot snapshot;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        snapshot.stages[i].calls = instrumentation::counters()[i].calls.load(std::memory_order_relaxed);
+        snapshot.stages[i].nanoseconds = instrumentation::counters()[i].nanoseconds.load(std::memory_order_relaxed);
+    }
+    return snapshot;
+}
+
+inline void resetInstrumentation() {
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        instrumentation::counters()[i].calls.store(0, std::memory_order_relaxed);
+        instrumentation::counters()[i].nanoseconds.store(0, std::memory_order_relaxed);
+    }
+}
+
+// One line per stage: name, calls, total milliseconds and nanoseconds per call
+inline void writeInstrumentation(ReportBuffer& report, const InstrumentationSnapshot& snapshot) {
+    report.append("===================== STAGE STATS =====================\n");
+    if (!INSTRUMENTATION_ENABLED) {
+        report.append("(instrumentation disabled; build with -DTAX_INSTRUMENTATION)\n");
+    }
+    report.appendPadded("Stage", 24).appendPadded("Calls", 14).appendPadded("Total (ms)", 14).append("ns/call\n");
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const StageStats& stats = snapshot.stages[i];
+        double perCall = stats.calls == 0 ? 0 : static_cast<double>(stats.nanoseconds) / static_cast<double>(stats.calls);
+        report.appendPadded(stageName(static_cast<Stage>(i)), 24)
+              .appendInteger(static_cast<long long>(stats.calls), 14)
+              .appendFixed(static_cast<double>(stats.nanoseconds) / 1e6, 3, 14)
+              .appendFixed(perCall, 1).append('\n');
+    }
+}
+
+// Writes a snapshot to 'stream' every 'interval' until destroyed, and once
+// more on destruction
+class PeriodicStatsDump {
+public:
+    PeriodicStatsDump(std::FILE* stream, std::chrono::milliseconds interval)
+        : stream(stream), interval(interval), stopping(false), worker(&PeriodicStatsDump::run, this) {}
+
+    ~PeriodicStatsDump() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        worker.join();
+        dump();
+    }
+
+    PeriodicStatsDump(const PeriodicStatsDump&) = delete;
+    PeriodicStatsDump& operator=(const PeriodicStatsDump&) = delete;
+
+private:
+    std::FILE* stream;
+    std::chrono::milliseconds interval;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!wake.wait_for(lock, interval, [this] { return stopping; })) {
+            dump();
+        }
+    }
+
+    void dump() {
+        ReportBuffer report;
+        report.attach(stream);
+        writeInstrumentation(report, instrumentationSnapshot());
+        report.flush();
+        std::fflush(stream);
+    }
+};
+
+#endif
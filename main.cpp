@@ -1,314 +1,886 @@
 #include <iostream>
 #include <fstream>
 #include <iomanip>
-#include <ctime>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include <string_view>
 #include <vector>
+#include <thread>
 #include <map>
 #include <algorithm>
-
-enum class AssessmentType { INDIVIDUAL, JOINT, SOLE_PROPRIETOR };
-
-struct IncomeSource {
-    std::string type;
-    double amount;
+#include "tax_calculator.hpp"
+#include "tax_schedule.hpp"
+#include "fixed_point.hpp"
+#include "instrumentation.hpp"
+#include "thread_pool.hpp"
+#include "report_buffer.hpp"
+#include "date_context.hpp"
+#include "category_table.hpp"
+#include "chunk_pipeline.hpp"
+#include "mapped_file.hpp"
+#include "net_income.hpp"
+#include "record_reader.hpp"
+#include "relief_optimizer.hpp"
+#include "relief_tax.hpp"
+#include "results_file.hpp"
+#include "tax_cache.hpp"
+#include "tax_daemon.hpp"
+#include "tax_sweep.hpp"
+
+// ===================== BATCH ASSESSMENT =====================
+// Taxpayer CSV (--batch), one taxpayer per line:
+//   name,ic_no,assessment_type,incomes,expenses[,filing_date]
+// Household CSV (--households), one married couple per line:
+//   name1,ic_no1,income1,name2,ic_no2,income2,expenses[,reliefs]
+// Relief claim CSV (--reliefs), one taxpayer with raw V4 relief answers per line:
+//   name,ic_no,assessment_type,marital_status,children,incomes,claims
+// assessment_type is "Individual", "Joint" or "Sole Proprietor".
+// incomes is a ';' separated list of "type:amount".
+// expenses is a ';' separated list of "category:description:amount".
+// reliefs is a ';' separated list of "relief_no:amount" for the transferable
+// reliefs (parents, spouse, children), numbered 1-23 as in the relief selection.
+// filing_date is "YYYY-MM-DD"; without it the return counts as filed today.
+// marital_status is S, M or D and children Y or N, as in the relief selection.
+// claims is a ';' separated list of "relief_no:answer", the answer being the
+// amount spent in RM or, for reliefs 16-18, the number of children; answers
+// are whole numbers, and repeated claims for one relief are added up.
+// A first line starting with "name" is treated as a header and skipped.
+//
+// The input file is memory-mapped and parsed in place: names, IC numbers
+// and list fields are std::string_views into the mapping. Every mode streams
+// the lines through a reader, compute and writer pipeline (runChunkPipeline)
+// in chunks of --chunk lines; chunks are written back in input order, so the
+// output does not depend on the thread count.
+
+struct BatchOptions {
+    unsigned threads = 0;          // 0 = one per hardware thread
+    std::size_t chunkSize = 1024;  // records per pipeline chunk (grid points per task for --sweep)
+    ArithmeticMode arithmeticMode = ArithmeticMode::FLOATING_POINT;
+    long statsInterval = 0;        // seconds between stage stats dumps, 0 = none
+    bool columnar = false;         // --batch only: write a results file (results_file.hpp) instead of CSV
+    std::size_t cacheEntries = 0;  // tax cache capacity (tax_cache.hpp), 0 = no cache
+    std::string cacheFile;         // tax cache warmed from and saved to this file
 };
 
-struct Expense {
-    std::string category;
-    std::string description;
-    double amount;
-};
+bool parseAssessmentType(std::string_view text, AssessmentType& type) {
+    if (text == "Individual") {
+        type = AssessmentType::INDIVIDUAL;
+    } else if (text == "Joint") {
+        type = AssessmentType::JOINT;
+    } else if (text == "Sole Proprietor") {
+        type = AssessmentType::SOLE_PROPRIETOR;
+    } else {
+        return false;
+    }
+    return true;
+}
 
-// List of allowed expense categories as per Malaysian tax laws
-const std::vector<std::string> ALLOWED_CATEGORIES = {
-    "Medical",
-    "Insurance",
-    "Education",
-    "Donations",
-    "Parental Care",
-    "Savings",
-    "Lifestyle",
-    "Books and Equipment"
+// Scratch buffers reused by one batch task across its records
+struct ParseScratch {
+    std::vector<std::string_view> fields, items, parts;
+    std::vector<ExpenseRef> expenses; // descriptions point into the record
+    std::vector<ReliefClaim> reliefs;
+    // Expense categories skipped as not allowed, until the caller reports and clears them
+    std::vector<std::string_view> rejectedCategories;
+    // Arena for the calculators of one record, released before the next;
+    // spills to the heap only for records larger than the buffer
+    alignas(std::max_align_t) char arenaBuffer[16384];
+    std::pmr::monotonic_buffer_resource arena{arenaBuffer, sizeof(arenaBuffer)};
 };
 
-class TaxCalculator {
-public:
-    TaxCalculator(const std::string& name, const std::string& icNo, AssessmentType type)
-        : name(name), icNo(icNo), assessmentType(type), totalDeductions(0) {}
-
-    void addIncomeSource(const std::string& type, double amount) {
-        incomeSources.push_back({type, amount});
+bool parseExpenseList(std::string_view text, std::vector<ExpenseRef>& expenses, ParseScratch& scratch) {
+    expenses.clear();
+    if (text.empty()) {
+        return true;
     }
-
-    void addExpense(const std::string& category, const std::string& description, double amount) {
-        if (isCategoryAllowed(category)) {
-            expenses.push_back({category, description, amount});
-        } else {
-            std::cerr << "Category '" << category << "' is not allowed as per tax laws.\n";
+    splitFields(text, ';', scratch.items);
+    for (const auto& item : scratch.items) {
+        double amount;
+        splitFields(item, ':', scratch.parts);
+        if (scratch.parts.size() != 3 || !parseAmount(scratch.parts[2], amount)) {
+            return false;
         }
+        ExpenseCategory category = findExpenseCategory(scratch.parts[0]);
+        if (category == ExpenseCategory::UNKNOWN) {
+            scratch.rejectedCategories.push_back(scratch.parts[0]);
+            continue;
+        }
+        expenses.push_back({category, scratch.parts[1], amount});
     }
+    return true;
+}
 
-    double calculateTaxableIncome() {
-        double totalIncome = 0;
-        for (const auto& income : incomeSources) {
-            totalIncome += income.amount;
+bool parseReliefList(std::string_view text, std::vector<ReliefClaim>& reliefs, ParseScratch& scratch) {
+    reliefs.clear();
+    if (text.empty()) {
+        return true;
+    }
+    splitFields(text, ';', scratch.items);
+    for (const auto& item : scratch.items) {
+        double number, amount;
+        splitFields(item, ':', scratch.parts);
+        if (scratch.parts.size() != 2 || !parseAmount(scratch.parts[0], number) ||
+            !parseAmount(scratch.parts[1], amount) || amount < 0) {
+            return false;
+        }
+        int category = static_cast<int>(number) - 1;
+        if (category < 0 || category >= RELIEF_CATEGORY_COUNT || category + 1 != number ||
+            !RELIEF_TRANSFERABLE[category]) {
+            return false;
         }
-        return totalIncome - calculateTotalDeductions();
+        reliefs.push_back({category, amount});
     }
+    return true;
+}
 
-    double calculateTax() {
-        double taxableIncome = calculateTaxableIncome();
-
-        switch (assessmentType) {
-            case AssessmentType::INDIVIDUAL:
-                return calculateIndividualTax(taxableIncome);
-            case AssessmentType::JOINT:
-                return calculateJointTax(taxableIncome);
-            case AssessmentType::SOLE_PROPRIETOR:
-                return calculateSoleProprietorTax(taxableIncome);
-            default:
-                return 0;
+// Appends the taxpayer on 'line' to 'batch'; returns false (and adds nothing) if malformed.
+// A record without a filing date counts as filed on 'dates' current day.
+bool parseTaxpayerLine(std::string_view line, TaxpayerBatch& batch, ParseScratch& scratch, const DateContext& dates) {
+    std::vector<std::string_view>& fields = scratch.fields;
+    splitFields(line, ',', fields);
+    AssessmentType type;
+    if ((fields.size() != 5 && fields.size() != 6) || !parseAssessmentType(fields[2], type)) {
+        return false;
+    }
+    long filingDay = dates.currentDay();
+    if (fields.size() == 6 && !fields[5].empty()) {
+        CivilDate filingDate;
+        if (!parseCivilDate(fields[5], filingDate)) {
+            return false;
         }
+        filingDay = daysFromCivil(filingDate);
     }
 
-    void generateTaxSummary(const std::string& filename) {
-        std::ofstream outFile(filename);
-        if (!outFile) {
-            std::cerr << "Error opening file for writing." << std::endl;
-            return;
+    batch.addTaxpayer(fields[0], fields[1], type, filingDay);
+
+    if (!fields[3].empty()) {
+        splitFields(fields[3], ';', scratch.items);
+        for (const auto& item : scratch.items) {
+            double amount;
+            splitFields(item, ':', scratch.parts);
+            if (scratch.parts.size() != 2 || !parseAmount(scratch.parts[1], amount)) {
+                batch.discardLast();
+                return false;
+            }
+            batch.addIncomeSource(amount);
         }
+    }
 
-        outFile << "===================== TAX SUMMARY =====================\n";
-        outFile << std::setw(20) << std::left << "Name" << ": " << name << "\n";
-        outFile << std::setw(20) << "IC No." << ": " << icNo << "\n";
-        outFile << std::setw(20) << "Assessment Type" << ": ";
-        switch (assessmentType) {
-            case AssessmentType::INDIVIDUAL:
-                outFile << "Individual\n";
-                break;
-            case AssessmentType::JOINT:
-                outFile << "Joint\n";
-                break;
-            case AssessmentType::SOLE_PROPRIETOR:
-                outFile << "Sole Proprietor\n";
-                break;
+    if (!fields[4].empty()) {
+        splitFields(fields[4], ';', scratch.items);
+        for (const auto& item : scratch.items) {
+            double amount;
+            splitFields(item, ':', scratch.parts);
+            if (scratch.parts.size() != 3 || !parseAmount(scratch.parts[2], amount)) {
+                batch.discardLast();
+                return false;
+            }
+            if (!batch.addExpense(scratch.parts[0], amount)) {
+                scratch.rejectedCategories.push_back(scratch.parts[0]);
+            }
         }
-        outFile << std::setw(20) << "Current Date" << ": " << getCurrentDate() << "\n";
-        outFile << std::setw(20) << "Tax Deadline" << ": " << getTaxDeadline() << "\n";
-        outFile << std::setw(20) << "Days Remaining" << ": " << getDaysRemaining() << "\n";
-        outFile << "--------------------------------------------------------\n";
-        outFile << std::setw(30) << "Income Source" << std::setw(15) << "Amount (RM)" << "\n";
-        outFile << "--------------------------------------------------------\n";
+    }
+    return true;
+}
+
+struct HouseholdResult {
+    bool valid;
+    std::string_view icNo1;
+    std::string_view icNo2;
+    HouseholdComparison comparison;
+};
 
-        for (const auto& income : incomeSources) {
-            outFile << std::setw(30) << income.type << std::setw(15) << income.amount << "\n";
+bool assessHouseholdLine(std::string_view line, HouseholdResult& result, ParseScratch& scratch, ArithmeticMode mode) {
+    std::vector<std::string_view>& fields = scratch.fields;
+    double income1, income2;
+    {
+        TAX_STAGE_TIMER(Stage::PARSING);
+        splitFields(line, ',', fields);
+        if ((fields.size() != 7 && fields.size() != 8) || !parseAmount(fields[2], income1) ||
+            !parseAmount(fields[5], income2)) {
+            return false;
+        }
+        if (!parseExpenseList(fields[6], scratch.expenses, scratch)) {
+            return false;
+        }
+        if (fields.size() == 8) {
+            if (!parseReliefList(fields[7], scratch.reliefs, scratch)) {
+                return false;
+            }
+        } else {
+            scratch.reliefs.clear();
         }
+    }
+    result.icNo1 = fields[1];
+    result.icNo2 = fields[4];
+    scratch.arena.release();
+    result.comparison = assessHousehold(fields[0], fields[1], income1, fields[3], fields[4], income2,
+                                        scratch.expenses, scratch.reliefs, mode, &scratch.arena);
+    return true;
+}
 
-        outFile << "--------------------------------------------------------\n";
-        outFile << std::setw(30) << "Total Income" << std::setw(15) << calculateTaxableIncome() + calculateTotalDeductions() << "\n";
-        outFile << "--------------------------------------------------------\n";
-        outFile << std::setw(30) << "Expense Category" << std::setw(20) << "Description" << std::setw(15) << "Amount (RM)" << "\n";
-        outFile << "--------------------------------------------------------\n";
+struct ReliefTaxResult {
+    bool valid;
+    std::string_view name;
+    std::string_view icNo;
+    AssessmentType type;
+    ReliefTaxAssessment assessment;
+};
 
-        for (const auto& expense : expenses) {
-            outFile << std::setw(30) << expense.category << std::setw(20) << expense.description << std::setw(15) << expense.amount << "\n";
+// Parses one relief claim line: name, IC number and type into 'result', the
+// rest into 'profile', 'totalIncome' and the RELIEF_COLUMNS raw 'claims'
+bool parseReliefClaimLine(std::string_view line, ReliefTaxResult& result, ReliefProfile& profile,
+                          double& totalIncome, std::int32_t* claims, ParseScratch& scratch) {
+    TAX_STAGE_TIMER(Stage::PARSING);
+    std::vector<std::string_view>& fields = scratch.fields;
+    splitFields(line, ',', fields);
+    if (fields.size() != 7 || !parseAssessmentType(fields[2], result.type) ||
+        (fields[3] != "S" && fields[3] != "M" && fields[3] != "D") || (fields[4] != "Y" && fields[4] != "N")) {
+        return false;
+    }
+    profile = reliefProfile(fields[3] != "S", fields[4] == "Y");
+
+    totalIncome = 0;
+    if (!fields[5].empty()) {
+        splitFields(fields[5], ';', scratch.items);
+        for (const auto& item : scratch.items) {
+            double amount;
+            splitFields(item, ':', scratch.parts);
+            if (scratch.parts.size() != 2 || !parseAmount(scratch.parts[1], amount)) {
+                return false;
+            }
+            totalIncome += amount;
+        }
+    }
+
+    // Repeated claims for one relief add up; the sum saturates instead of wrapping
+    long long sums[RELIEF_COLUMNS] = {};
+    if (!fields[6].empty()) {
+        splitFields(fields[6], ';', scratch.items);
+        for (const auto& item : scratch.items) {
+            double number, answer;
+            splitFields(item, ':', scratch.parts);
+            if (scratch.parts.size() != 2 || !parseAmount(scratch.parts[0], number) ||
+                !parseAmount(scratch.parts[1], answer) || number < 1 || number > RELIEF_CATEGORY_COUNT ||
+                number != static_cast<int>(number) || answer < 0 || answer > 1e9 ||
+                answer != static_cast<std::int32_t>(answer)) {
+                return false;
+            }
+            sums[static_cast<int>(number) - 1] += static_cast<long long>(answer);
         }
+    }
+    for (int c = 0; c < RELIEF_COLUMNS; c++) {
+        claims[c] = static_cast<std::int32_t>(sums[c] < INT32_MAX ? sums[c] : INT32_MAX);
+    }
 
-        outFile << "--------------------------------------------------------\n";
-        outFile << std::setw(30) << "Total Deductions" << std::setw(15) << calculateTotalDeductions() << "\n";
-        outFile << std::setw(30) << "Taxable Income" << std::setw(15) << calculateTaxableIncome() << "\n";
-        outFile << std::setw(30) << "Income Tax" << std::setw(15) << calculateTax() << "\n";
-        outFile << "========================================================\n";
+    result.name = fields[0];
+    result.icNo = fields[1];
+    return true;
+}
 
-        outFile.close();
-        std::cout << "Tax summary written to " << filename << std::endl;
+// Parses one relief claim line and assesses it in the same pass
+bool assessReliefLine(std::string_view line, ReliefTaxResult& result, ParseScratch& scratch, ArithmeticMode mode) {
+    ReliefProfile profile;
+    double totalIncome;
+    std::int32_t claims[RELIEF_COLUMNS];
+    if (!parseReliefClaimLine(line, result, profile, totalIncome, claims, scratch)) {
+        return false;
     }
+    result.assessment = assessWithReliefs(result.type, profile, totalIncome, claims, mode);
+    return true;
+}
 
-private:
-    std::string name;
-    std::string icNo;
-    AssessmentType assessmentType;
-    std::vector<IncomeSource> incomeSources;
-    std::vector<Expense> expenses;
-    double totalDeductions;
+// One output row per result, shared by the batch modes and the daemon
+void writeTaxpayerRow(ReportBuffer& out, const TaxpayerBatch& batch, const TaxpayerBatch::Results& results,
+                      std::size_t i) {
+    out.append(batch.name(i)).append(',').append(batch.icNo(i)).append(',')
+       .append(assessmentTypeName(batch.assessmentType(i))).append(',')
+       .appendAmount(results.totalIncome[i]).append(',')
+       .appendAmount(results.totalDeductions[i]).append(',')
+       .appendAmount(results.taxableIncome[i]).append(',')
+       .appendAmount(results.tax[i]).append(',')
+       .appendInteger(results.daysLate[i])
+       .append('\n');
+}
+
+void writeHouseholdRow(ReportBuffer& out, const HouseholdResult& result) {
+    const HouseholdComparison& c = result.comparison;
+    const char* lower = c.jointTax < c.totalOptimizedTax ? "Joint"
+                      : c.jointTax > c.totalOptimizedTax ? "Individual" : "Same";
+    out.append(result.icNo1).append(',').append(result.icNo2).append(',')
+       .appendAmount(c.individualTax1).append(',').appendAmount(c.individualTax2).append(',')
+       .appendAmount(c.totalIndividualTax).append(',').appendAmount(c.jointTax).append(',')
+       .append(lower).append(',').appendAmount(c.reliefToSpouse1).append(',')
+       .appendAmount(c.optimizedTax1).append(',').appendAmount(c.optimizedTax2).append(',')
+       .appendAmount(c.totalOptimizedTax).append('\n');
+}
+
+void writeReliefRow(ReportBuffer& out, const ReliefTaxResult& result) {
+    const ReliefTaxAssessment& a = result.assessment;
+    out.append(result.name).append(',').append(result.icNo).append(',')
+       .append(assessmentTypeName(result.type)).append(',')
+       .appendAmount(a.totalIncome).append(',').appendAmount(a.totalRelief).append(',')
+       .appendAmount(a.taxableIncome).append(',').appendAmount(a.tax).append('\n');
+}
+
+// A message about one input line: an expense category that was skipped, or
+// (with no category) a malformed record
+struct LineDiagnostic {
+    long lineNumber;
+    std::string_view category;
+};
+
+// Chunk of input lines for runChunkPipeline (chunk_pipeline.hpp). The
+// compute stage collects diagnostics in line order; the writer reports them.
+struct LineChunk : PipelineChunk {
+    using Scratch = ParseScratch;
+    std::vector<LineDiagnostic> diagnostics;
 
-    bool isCategoryAllowed(const std::string& category) {
-        return std::find(ALLOWED_CATEGORIES.begin(), ALLOWED_CATEGORIES.end(), category) != ALLOWED_CATEGORIES.end();
+    // Records the categories 'scratch' skipped on line i and, if 'valid' is false, the line itself
+    void noteLine(std::size_t i, bool valid, ParseScratch& scratch) {
+        for (std::string_view category : scratch.rejectedCategories) {
+            diagnostics.push_back({lineNumbers[i], category});
+        }
+        scratch.rejectedCategories.clear();
+        if (!valid) {
+            diagnostics.push_back({lineNumbers[i], std::string_view()});
+        }
     }
 
-    double calculateTotalDeductions() {
-        totalDeductions = 0;
-        for (const auto& expense : expenses) {
-            totalDeductions += expense.amount;
-        }
-        return totalDeductions;
-    }
-
-    std::string getCurrentDate() {
-        time_t now = time(0);
-        tm* ltm = localtime(&now);
-        char buffer[11];
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d", ltm);
-        return std::string(buffer);
-    }
-
-    std::string getTaxDeadline() {
-        // Assume tax deadline is April 30th of the current year
-        time_t now = time(0);
-        tm* ltm = localtime(&now);
-        char buffer[11];
-        ltm->tm_mon = 3; // April (0-based month)
-        ltm->tm_mday = 30;
-        strftime(buffer, sizeof(buffer), "%Y-%m-%d", ltm);
-        return std::string(buffer);
-    }
-
-    int getDaysRemaining() {
-        std::string deadline = getTaxDeadline();
-        std::string currentDate = getCurrentDate();
-
-        tm deadlineTm = {};
-        tm currentTm = {};
-        std::istringstream deadlineStream(deadline);
-        deadlineStream >> std::get_time(&deadlineTm, "%Y-%m-%d");
-
-        std::istringstream currentStream(currentDate);
-        currentStream >> std::get_time(&currentTm, "%Y-%m-%d");
-
-        time_t deadlineTime = mktime(&deadlineTm);
-        time_t currentTime = mktime(&currentTm);
-
-        double secondsRemaining = difftime(deadlineTime, currentTime);
-        return static_cast<int>(secondsRemaining / (60 * 60 * 24));
-    }
-
-    double calculateIndividualTax(double taxableIncome) {
-        double tax = 0;
-
-        // Malaysian individual tax rates for 2023 (example rates)
-        if (taxableIncome <= 5000) {
-            tax = 0;
-        } else if (taxableIncome <= 20000) {
-            tax = (taxableIncome - 5000) * 0.01;
-        } else if (taxableIncome <= 35000) {
-            tax = 150 + (taxableIncome - 20000) * 0.03;
-        } else if (taxableIncome <= 50000) {
-            tax = 600 + (taxableIncome - 35000) * 0.06;
-        } else if (taxableIncome <= 70000) {
-            tax = 1800 + (taxableIncome - 50000) * 0.11;
-        } else if (taxableIncome <= 100000) {
-            tax = 4400 + (taxableIncome - 70000) * 0.19;
-        } else if (taxableIncome <= 250000) {
-            tax = 10300 + (taxableIncome - 100000) * 0.25;
-        } else {
-            tax = 50300 + (taxableIncome - 250000) * 0.28;
+    // Writes the diagnostics to std::cerr; returns the number of malformed records
+    int reportDiagnostics(const std::string& inputFile) const {
+        int malformed = 0;
+        for (const LineDiagnostic& diagnostic : diagnostics) {
+            std::cerr << inputFile << ":" << diagnostic.lineNumber << ": ";
+            if (diagnostic.category.empty()) {
+                std::cerr << "malformed record skipped.\n";
+                ++malformed;
+            } else {
+                std::cerr << "category '" << diagnostic.category << "' is not allowed as per tax laws.\n";
+            }
         }
+        return malformed;
+    }
+};
 
-        return tax;
+// Runs 'assess' over every line of 'inputFile' through runChunkPipeline and
+// hands each result to 'write' in input order. Returns the number of rejected lines, or -1.
+template <class Result, class Assess, class Write>
+int runLineBatch(const std::string& inputFile, const std::string& outputFile, const char* header,
+                 const BatchOptions& options, Assess assess, Write write) {
+    MappedFile inFile;
+    if (!inFile.open(inputFile)) {
+        std::cerr << "Error opening " << inputFile << " for reading." << std::endl;
+        return -1;
+    }
+    ReportBuffer outFile;
+    if (!outFile.open(outputFile)) {
+        std::cerr << "Error opening " << outputFile << " for writing." << std::endl;
+        return -1;
     }
 
-    double calculateJointTax(double taxableIncome) {
-        double tax = 0;
+    outFile.append(header).append('\n');
+
+    struct Chunk : LineChunk {
+        explicit Chunk(const BatchOptions&) {}
+        std::vector<Result> results;
+    };
+
+    long assessed = 0;
+    int rejected = 0;
+    runChunkPipeline<Chunk>(
+        inFile.text(), options,
+        [&](Chunk& chunk, ParseScratch& scratch) {
+            chunk.results.resize(chunk.lines.size());
+            chunk.diagnostics.clear();
+            for (std::size_t i = 0; i < chunk.lines.size(); i++) {
+                chunk.results[i].valid = assess(chunk.lines[i], chunk.results[i], scratch);
+                chunk.noteLine(i, chunk.results[i].valid, scratch);
+            }
+        },
+        [&](Chunk& chunk) {
+            rejected += chunk.reportDiagnostics(inputFile);
+            for (std::size_t i = 0; i < chunk.results.size(); i++) {
+                if (chunk.results[i].valid) {
+                    write(outFile, chunk.results[i]);
+                    ++assessed;
+                }
+            }
+        });
+
+    if (!outFile.close()) {
+        std::cerr << "Error writing " << outputFile << "." << std::endl;
+        return -1;
+    }
+    std::cout << assessed << " records assessed, " << rejected << " records rejected. Results written to "
+              << outputFile << std::endl;
+    return rejected;
+}
 
-        // Malaysian joint tax rates for 2023 (example rates)
-        if (taxableIncome <= 10000) {
-            tax = 0;
-        } else if (taxableIncome <= 40000) {
-            tax = (taxableIncome - 10000) * 0.02;
-        } else if (taxableIncome <= 70000) {
-            tax = 600 + (taxableIncome - 40000) * 0.05;
-        } else if (taxableIncome <= 100000) {
-            tax = 2100 + (taxableIncome - 70000) * 0.10;
-        } else if (taxableIncome <= 200000) {
-            tax = 5100 + (taxableIncome - 100000) * 0.16;
-        } else if (taxableIncome <= 500000) {
-            tax = 21100 + (taxableIncome - 200000) * 0.21;
-        } else {
-            tax = 84100 + (taxableIncome - 500000) * 0.24;
+// Assesses a taxpayer CSV through runChunkPipeline: the compute stage parses
+// each chunk into a TaxpayerBatch and calculates it, the writer writes it out
+int runBatchAssessment(const std::string& inputFile, const std::string& outputFile, const BatchOptions& options) {
+    MappedFile inFile;
+    if (!inFile.open(inputFile)) {
+        std::cerr << "Error opening " << inputFile << " for reading." << std::endl;
+        return -1;
+    }
+    ReportBuffer outFile;
+    ResultsFileWriter resultsFile;
+    if (!(options.columnar ? resultsFile.open(outputFile) : outFile.open(outputFile))) {
+        std::cerr << "Error opening " << outputFile << " for writing." << std::endl;
+        return -1;
+    }
+
+    if (!options.columnar) {
+        outFile.append("name,ic_no,assessment_type,total_income,total_deductions,taxable_income,income_tax,days_late\n");
+    }
+    const DateContext& dates = DateContext::current();
+
+    struct Chunk : LineChunk {
+        explicit Chunk(const BatchOptions& options) : batch(options.arithmeticMode) {}
+        TaxpayerBatch batch;
+        TaxpayerBatch::Results results;
+    };
+
+    long assessed = 0;
+    int rejected = 0;
+    runChunkPipeline<Chunk>(
+        inFile.text(), options,
+        [&](Chunk& chunk, ParseScratch& scratch) {
+            chunk.batch.clear();
+            chunk.diagnostics.clear();
+            {
+                TAX_STAGE_TIMER(Stage::PARSING);
+                for (std::size_t i = 0; i < chunk.lines.size(); i++) {
+                    chunk.noteLine(i, parseTaxpayerLine(chunk.lines[i], chunk.batch, scratch, dates), scratch);
+                }
+            }
+            chunk.batch.calculateTaxes(chunk.results);
+            if (!options.columnar) {
+                chunk.batch.calculateDaysLate(dates, chunk.results);
+            }
+        },
+        [&](Chunk& chunk) {
+            rejected += chunk.reportDiagnostics(inputFile);
+            assessed += static_cast<long>(chunk.batch.size());
+            for (std::size_t i = 0; i < chunk.batch.size(); i++) {
+                if (options.columnar) {
+                    resultsFile.append({icKey(chunk.batch.icNo(i)), chunk.batch.assessmentType(i),
+                                        chunk.results.totalIncome[i], chunk.results.totalDeductions[i],
+                                        chunk.results.taxableIncome[i], chunk.results.tax[i]});
+                } else {
+                    writeTaxpayerRow(outFile, chunk.batch, chunk.results, i);
+                }
+            }
+        });
+
+    if (!(options.columnar ? resultsFile.close() : outFile.close())) {
+        std::cerr << "Error writing " << outputFile << "." << std::endl;
+        return -1;
+    }
+    std::cout << assessed << " records assessed, " << rejected << " records rejected. Results written to "
+              << outputFile << std::endl;
+    return rejected;
+}
+
+// Converts a results file written by "--batch ... --columnar" back to CSV
+int dumpResultsFile(const std::string& inputFile, const std::string& outputFile) {
+    ResultsFileReader results;
+    if (!results.open(inputFile)) {
+        std::cerr << "Error reading " << inputFile << ": not a valid results file." << std::endl;
+        return -1;
+    }
+    ReportBuffer outFile;
+    if (!outFile.open(outputFile)) {
+        std::cerr << "Error opening " << outputFile << " for writing." << std::endl;
+        return -1;
+    }
+
+    outFile.append("ic_key,assessment_type,total_income,total_deductions,taxable_income,income_tax,effective_rate\n");
+    for (std::size_t g = 0; g < results.rowGroupCount(); g++) {
+        const ResultRowGroup& group = results.rowGroup(g);
+        for (std::size_t i = 0; i < group.rows; i++) {
+            outFile.appendUnsigned(group.icKeys[i]).append(',')
+                   .append(assessmentTypeName(static_cast<AssessmentType>(group.types[i]))).append(',')
+                   .appendAmount(group.totalIncome[i]).append(',').appendAmount(group.totalDeductions[i]).append(',')
+                   .appendAmount(group.taxableIncome[i]).append(',').appendAmount(group.tax[i]).append(',')
+                   .appendFixed(group.effectiveRate[i], 6).append('\n');
         }
+    }
 
-        return tax;
+    if (!outFile.close()) {
+        std::cerr << "Error writing " << outputFile << "." << std::endl;
+        return -1;
     }
+    std::cout << results.rowCount() << " records dumped to " << outputFile << std::endl;
+    return 0;
+}
+
+int runReliefBatch(const std::string& inputFile, const std::string& outputFile, const BatchOptions& options) {
+    return runLineBatch<ReliefTaxResult>(
+        inputFile, outputFile, "name,ic_no,assessment_type,total_income,total_relief,taxable_income,income_tax",
+        options,
+        [&options](std::string_view line, ReliefTaxResult& result, ParseScratch& scratch) {
+            return assessReliefLine(line, result, scratch, options.arithmeticMode);
+        },
+        writeReliefRow);
+}
 
-    double calculateSoleProprietorTax(double taxableIncome) {
-        double tax = 0;
+int runHouseholdBatch(const std::string& inputFile, const std::string& outputFile, const BatchOptions& options) {
+    return runLineBatch<HouseholdResult>(
+        inputFile, outputFile,
+        "ic_no1,ic_no2,individual_tax1,individual_tax2,total_individual_tax,joint_tax,lower_assessment,"
+        "relief_to_spouse1,optimized_tax1,optimized_tax2,total_optimized_tax", options,
+        [&options](std::string_view line, HouseholdResult& result, ParseScratch& scratch) {
+            return assessHouseholdLine(line, result, scratch, options.arithmeticMode);
+        },
+        writeHouseholdRow);
+}
 
-        // Malaysian sole proprietor tax rates for 2023 (example rates)
-        if (taxableIncome <= 50000) {
-            tax = taxableIncome * 0.15;
-        } else if (taxableIncome <= 100000) {
-            tax = 7500 + (taxableIncome - 50000) * 0.20;
-        } else if (taxableIncome <= 200000) {
-            tax = 17500 + (taxableIncome - 100000) * 0.25;
+// Largest --threads accepted; every thread is started up front
+const long MAX_THREADS = 4096;
+
+// Parses "--threads N", "--chunk N", "--stats N", "--cache N", "--cache-file F", "--fixed-point"
+// and "--columnar" starting at argv[first]. Only the options in 'accepted' are
+// allowed, so a mode rejects the ones it would otherwise silently ignore.
+bool parseBatchOptions(int argc, char* argv[], int first, std::initializer_list<std::string_view> accepted,
+                       BatchOptions& options) {
+    int i = first;
+    while (i < argc) {
+        std::string_view option = argv[i++];
+        if (std::find(accepted.begin(), accepted.end(), option) == accepted.end()) {
+            std::cerr << "Unknown option for this mode: " << option << "\n";
+            return false;
+        }
+        if (option == "--fixed-point") {
+            options.arithmeticMode = ArithmeticMode::FIXED_POINT;
+            continue;
+        }
+        if (option == "--columnar") {
+            options.columnar = true;
+            continue;
+        }
+        if (i >= argc) {
+            std::cerr << "Missing value for " << option << "\n";
+            return false;
+        }
+        if (option == "--cache-file") {
+            options.cacheFile = argv[i++];
+            continue;
+        }
+        long value;
+        bool valid = parseCount(argv[i++], value);
+        if (valid && option == "--threads" && value >= 0 && value <= MAX_THREADS) {
+            options.threads = static_cast<unsigned>(value);
+        } else if (valid && option == "--chunk" && value > 0) {
+            options.chunkSize = static_cast<std::size_t>(value);
+        } else if (valid && option == "--stats" && value > 0) {
+            options.statsInterval = value;
+        } else if (valid && option == "--cache" && value > 0) {
+            options.cacheEntries = static_cast<std::size_t>(value);
         } else {
-            tax = 42500 + (taxableIncome - 200000) * 0.30;
+            std::cerr << "Invalid value for " << option << ": " << argv[i - 1] << "\n";
+            return false;
         }
-
-        return tax;
     }
-};
+    return true;
+}
 
-void compareAssessments(const std::string& name1, const std::string& icNo1, double income1,
-                        const std::string& name2, const std::string& icNo2, double income2,
-                        const std::vector<Expense>& expenses, const std::string& filename) {
-    // Create Individual Assessment for Person 1
-    TaxCalculator individual1(name1, icNo1, AssessmentType::INDIVIDUAL);
-    for (const auto& expense : expenses) {
-        individual1.addExpense(expense.category, expense.description, expense.amount);
+// Creates and installs the tax cache requested by --cache/--cache-file, if any
+std::unique_ptr<TaxCache> openTaxCache(const BatchOptions& options) {
+    std::unique_ptr<TaxCache> cache;
+    if (options.cacheEntries > 0 || !options.cacheFile.empty()) {
+        cache.reset(new TaxCache(options.cacheEntries > 0 ? options.cacheEntries : std::size_t(1) << 20));
+        if (!options.cacheFile.empty() && cache->warm(options.cacheFile) < 0) {
+            std::cerr << "Starting with an empty tax cache: cannot read " << options.cacheFile << "." << std::endl;
+        }
+        installTaxCache(cache.get());
     }
-    individual1.addIncomeSource("Salary", income1);
+    return cache;
+}
 
-    // Create Individual Assessment for Person 2
-    TaxCalculator individual2(name2, icNo2, AssessmentType::INDIVIDUAL);
-    for (const auto& expense : expenses) {
-        individual2.addExpense(expense.category, expense.description, expense.amount);
+// Uninstalls the cache, reports its statistics and saves it to --cache-file
+void closeTaxCache(std::unique_ptr<TaxCache>& cache, const BatchOptions& options) {
+    if (!cache) {
+        return;
+    }
+    installTaxCache(nullptr);
+    TaxCacheStats cacheStats = cache->stats();
+    std::cerr << "Tax cache: " << cacheStats.hits << " hits, " << cacheStats.misses << " misses, "
+              << cacheStats.evictions << " evictions, " << cacheStats.entries << " entries" << std::endl;
+    if (!options.cacheFile.empty() && !cache->save(options.cacheFile)) {
+        std::cerr << "Error writing " << options.cacheFile << "." << std::endl;
     }
-    individual2.addIncomeSource("Salary", income2);
+    cache.reset();
+}
 
-    // Create Joint Assessment
-    TaxCalculator joint(name1 + " & " + name2, icNo1 + ", " + icNo2, AssessmentType::JOINT);
-    for (const auto& expense : expenses) {
-        joint.addExpense(expense.category, expense.description, expense.amount);
+// ===================== TAX CURVES =====================
+// Writes tax, effective rate and marginal rate for every assessment type
+// over an income grid (--sweep):
+//   income,individual_tax,individual_effective_rate,individual_marginal_rate,joint_...,sole_proprietor_...
+// Blocks of the grid are computed and formatted in parallel chunks, then
+// written in order.
+int runTaxSweep(const std::string& outputFile, const IncomeGrid& grid, const BatchOptions& options) {
+    ReportBuffer outFile;
+    if (!outFile.open(outputFile)) {
+        std::cerr << "Error opening " << outputFile << " for writing." << std::endl;
+        return -1;
+    }
+    outFile.append("income");
+    const char* prefixes[3] = {"individual", "joint", "sole_proprietor"};
+    for (const char* prefix : prefixes) {
+        outFile.append(',').append(prefix).append("_tax,").append(prefix).append("_effective_rate,")
+               .append(prefix).append("_marginal_rate");
+    }
+    outFile.append('\n');
+
+    const AssessmentType types[3] = {AssessmentType::INDIVIDUAL, AssessmentType::JOINT,
+                                     AssessmentType::SOLE_PROPRIETOR};
+    struct Chunk {
+        std::vector<double> tax[3], effectiveRate[3], marginalRate[3];
+        ReportBuffer text;
+    };
+
+    WorkStealingPool pool(options.threads);
+    // A few chunks per thread in flight, so formatted text stays small
+    std::size_t blockPoints = options.chunkSize * pool.size() * 4;
+    std::vector<Chunk> chunks((blockPoints + options.chunkSize - 1) / options.chunkSize);
+    for (std::size_t blockStart = 0; blockStart < grid.points; blockStart += blockPoints) {
+        std::size_t blockEnd = blockStart + blockPoints < grid.points ? blockStart + blockPoints : grid.points;
+        pool.parallelFor(blockEnd - blockStart, options.chunkSize, [&](std::size_t begin, std::size_t end) {
+            Chunk& chunk = chunks[begin / options.chunkSize];
+            std::size_t count = end - begin;
+            for (int t = 0; t < 3; t++) {
+                chunk.tax[t].resize(count);
+                chunk.effectiveRate[t].resize(count);
+                chunk.marginalRate[t].resize(count);
+                sweepTaxCurves(scheduleFor(types[t]), grid, blockStart + begin, blockStart + end,
+                               chunk.tax[t].data(), chunk.effectiveRate[t].data(), chunk.marginalRate[t].data());
+            }
+            chunk.text.clear();
+            for (std::size_t i = 0; i < count; i++) {
+                chunk.text.appendAmount(grid.income(blockStart + begin + i));
+                for (int t = 0; t < 3; t++) {
+                    chunk.text.append(',').appendAmount(chunk.tax[t][i]).append(',')
+                              .appendFixed(chunk.effectiveRate[t][i], 6).append(',')
+                              .appendFixed(chunk.marginalRate[t][i], 4);
+                }
+                chunk.text.append('\n');
+            }
+        });
+        std::size_t chunkCount = (blockEnd - blockStart + options.chunkSize - 1) / options.chunkSize;
+        for (std::size_t c = 0; c < chunkCount; c++) {
+            outFile.append(chunks[c].text.view());
+        }
     }
-    joint.addIncomeSource("Salary", income1 + income2);
 
-    // Calculate taxes
-    double individualTax1 = individual1.calculateTax();
-    double individualTax2 = individual2.calculateTax();
-    double totalIndividualTax = individualTax1 + individualTax2;
-    double jointTax = joint.calculateTax();
+    if (!outFile.close()) {
+        std::cerr << "Error writing " << outputFile << "." << std::endl;
+        return -1;
+    }
+    std::cout << grid.points << " incomes evaluated. Tax curves written to " << outputFile << std::endl;
+    return 0;
+}
 
-    // Write comparison to file
-    std::ofstream outFile(filename);
-    if (!outFile) {
-        std::cerr << "Error opening file for writing." << std::endl;
-        return;
+// Parses "--from X", "--to X" and "--step X" for --sweep, then "--threads N" and "--chunk N"
+bool parseSweepOptions(int argc, char* argv[], int first, IncomeGrid& grid, BatchOptions& options) {
+    double from = 0, to = 2000000, step = 1;
+    std::vector<char*> rest(argv, argv + first);
+    for (int i = first; i < argc; i++) {
+        std::string option = argv[i];
+        if (option == "--from" || option == "--to" || option == "--step") {
+            double value;
+            if (i + 1 >= argc || !parseAmount(argv[++i], value)) {
+                std::cerr << "Invalid value for " << option << "\n";
+                return false;
+            }
+            (option == "--from" ? from : option == "--to" ? to : step) = value;
+        } else {
+            rest.push_back(argv[i]);
+        }
     }
+    grid = makeIncomeGrid(from, to, step);
+    if (grid.points == 0) {
+        std::cerr << "The income grid must run upwards and have at most " << MAX_GRID_POINTS << " points.\n";
+        return false;
+    }
+    return parseBatchOptions(static_cast<int>(rest.size()), rest.data(), first, {"--threads", "--chunk"}, options);
+}
 
-    outFile << "===================== TAX COMPARISON =====================\n";
-    outFile << std::setw(30) << std::left << "Assessment Type" << std::setw(20) << "Tax (RM)" << "\n";
-    outFile << "--------------------------------------------------------\n";
-    outFile << std::setw(30) << "Individual Assessment (Person 1)" << std::setw(20) << individualTax1 << "\n";
-    outFile << std::setw(30) << "Individual Assessment (Person 2)" << std::setw(20) << individualTax2 << "\n";
-    outFile << std::setw(30) << "Total Individual Tax" << std::setw(20) << totalIndividualTax << "\n";
-    outFile << std::setw(30) << "Joint Assessment" << std::setw(20) << jointTax << "\n";
-    outFile << "--------------------------------------------------------\n";
+// ===================== DAEMON =====================
+// Request lines for --serve, one reply line each:
+//   TAX <taxpayer record>      OK name,ic_no,assessment_type,total_income,total_deductions,taxable_income,income_tax,days_late
+//   COMPARE <household record> OK ic_no1,ic_no2,individual_tax1,...,total_optimized_tax
+//   RELIEF <relief record>     OK name,ic_no,assessment_type,total_income,total_relief,taxable_income,income_tax
+//   PING                       OK
+// Records use the same fields as the --batch, --households and --reliefs
+// input files. Anything else gets "ERR <reason>".
+class DaemonRequestHandler {
+public:
+    explicit DaemonRequestHandler(ArithmeticMode mode)
+        : mode(mode), dates(DateContext::localToday()), batch(mode) {}
 
-    if (jointTax < totalIndividualTax) {
-        outFile << "Joint Assessment provides lower tax.\n";
-    } else if (jointTax > totalIndividualTax) {
-        outFile << "Individual Assessment provides lower tax.\n";
-    } else {
-        outFile << "Both assessments result in the same tax.\n";
+    void operator()(std::string_view request, ReportBuffer& reply) {
+        answer(request, reply);
+        for (std::string_view category : scratch.rejectedCategories) {
+            std::cerr << "Category '" << category << "' is not allowed as per tax laws.\n";
+        }
+        scratch.rejectedCategories.clear();
     }
 
-    outFile << "========================================================\n";
+private:
+    ArithmeticMode mode;
+    DateContext dates;
+    ParseScratch scratch;
+    TaxpayerBatch batch;
+    TaxpayerBatch::Results results;
+    HouseholdResult household;
+    ReliefTaxResult relief;
+
+    void answer(std::string_view request, ReportBuffer& reply) {
+        std::size_t space = request.find(' ');
+        std::string_view command = request.substr(0, space);
+        std::string_view record = space == std::string_view::npos ? std::string_view() : request.substr(space + 1);
+
+        if (command == "TAX") {
+            // A long-running server must not keep the day it was started on
+            CivilDate today = DateContext::localToday();
+            if (today.day != dates.currentDate().day || today.month != dates.currentDate().month ||
+                today.year != dates.currentDate().year) {
+                dates = DateContext(today);
+            }
+            batch.clear();
+            if (!parseTaxpayerLine(record, batch, scratch, dates)) {
+                reply.append("ERR malformed taxpayer record\n");
+                return;
+            }
+            batch.calculateTaxes(results);
+            batch.calculateDaysLate(dates, results);
+            writeTaxpayerRow(reply.append("OK "), batch, results, 0);
+        } else if (command == "COMPARE") {
+            if (!assessHouseholdLine(record, household, scratch, mode)) {
+                reply.append("ERR malformed household record\n");
+                return;
+            }
+            writeHouseholdRow(reply.append("OK "), household);
+        } else if (command == "RELIEF") {
+            if (!assessReliefLine(record, relief, scratch, mode)) {
+                reply.append("ERR malformed relief record\n");
+                return;
+            }
+            writeReliefRow(reply.append("OK "), relief);
+        } else if (command == "PING") {
+            reply.append("OK\n");
+        } else {
+            reply.append("ERR unknown command\n");
+        }
+    }
+};
 
-    outFile.close();
-    std::cout << "Tax comparison written to " << filename << std::endl;
+int runDaemon(const std::string& socketPath, const BatchOptions& options) {
+#ifdef TAX_DAEMON_SUPPORTED
+    DaemonRequestHandler handler(options.arithmeticMode);
+    return serveUnixSocket(socketPath, handler);
+#else
+    (void)options;
+    std::cerr << "Cannot serve " << socketPath << ": daemon mode needs Linux (epoll)." << std::endl;
+    return -1;
+#endif
 }
 
-int main() {
+int main(int argc, char* argv[]) {
+    // Non-interactive batch modes:
+    //   main --batch <input.csv> <output> [--threads N] [--chunk N] [--stats N] [--fixed-point] [--columnar]
+    //   main --households <input.csv> <output.csv> [--threads N] [--chunk N] [--stats N] [--fixed-point] [--cache N] [--cache-file F]
+    //   main --reliefs <input.csv> <output.csv> [--threads N] [--chunk N] [--stats N] [--fixed-point] [--cache N] [--cache-file F]
+    //   main --sweep <output.csv> [--from X] [--to X] [--step X] [--threads N] [--chunk N]
+    //   main --dump-results <results.tcol> <output.csv>
+    //   main --serve <socket_path> [--fixed-point] [--cache N] [--cache-file F]   (Linux; see DAEMON above)
+    // --stats N writes stage stats to stderr every N seconds (see instrumentation.hpp).
+    // --columnar writes a binary results file instead of CSV (see results_file.hpp).
+    // --cache N memoizes up to N bracket evaluations; --cache-file F warms the cache from F
+    // and saves it back there afterwards (see tax_cache.hpp).
+    //   main --gross-for <net_income> [--type <assessment_type>] [--deductions X]
+    if (argc > 1 && std::string(argv[1]) == "--gross-for") {
+        double netIncome = 0, deductions = 0;
+        AssessmentType type = AssessmentType::INDIVIDUAL;
+        bool ok = argc >= 3 && parseAmount(argv[2], netIncome);
+        for (int i = 3; ok && i < argc; i += 2) {
+            std::string option = argv[i];
+            ok = i + 1 < argc && ((option == "--type" && parseAssessmentType(argv[i + 1], type)) ||
+                                  (option == "--deductions" && parseAmount(argv[i + 1], deductions)));
+        }
+        if (!ok) {
+            std::cerr << "Usage: " << argv[0]
+                      << " --gross-for <net_income> [--type Individual|Joint|\"Sole Proprietor\"] [--deductions X]\n";
+            return 1;
+        }
+        double gross = requiredGrossIncome(type, netIncome, deductions);
+        std::cout << std::fixed << std::setprecision(2) << "Gross income required (" << assessmentTypeName(type)
+                  << "): RM " << gross << std::endl;
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--sweep") {
+        BatchOptions options;
+        options.chunkSize = 16384;
+        IncomeGrid grid;
+        if (argc < 3 || !parseSweepOptions(argc, argv, 3, grid, options)) {
+            std::cerr << "Usage: " << argv[0]
+                      << " --sweep <output.csv> [--from X] [--to X] [--step X] [--threads N] [--chunk N]\n";
+            return 1;
+        }
+        return runTaxSweep(argv[2], grid, options) == 0 ? 0 : 1;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--serve") {
+        BatchOptions options;
+        if (argc < 3 || !parseBatchOptions(argc, argv, 3, {"--fixed-point", "--cache", "--cache-file"}, options)) {
+            std::cerr << "Usage: " << argv[0] << " --serve <socket_path> [--fixed-point] [--cache N] [--cache-file F]\n";
+            return 1;
+        }
+        std::unique_ptr<TaxCache> cache = openTaxCache(options);
+        int status = runDaemon(argv[2], options);
+        closeTaxCache(cache, options);
+        return status == 0 ? 0 : 1;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--dump-results") {
+        if (argc != 4) {
+            std::cerr << "Usage: " << argv[0] << " --dump-results <results.tcol> <output.csv>\n";
+            return 1;
+        }
+        return dumpResultsFile(argv[2], argv[3]) == 0 ? 0 : 1;
+    }
+    if (argc > 1 && (std::string(argv[1]) == "--batch" || std::string(argv[1]) == "--households" ||
+                     std::string(argv[1]) == "--reliefs")) {
+        BatchOptions options;
+        bool batch = std::string(argv[1]) == "--batch";
+        bool parsed = batch ? parseBatchOptions(argc, argv, 4, {"--threads", "--chunk", "--stats", "--fixed-point",
+                                                                "--columnar"}, options)
+                            : parseBatchOptions(argc, argv, 4, {"--threads", "--chunk", "--stats", "--fixed-point",
+                                                                "--cache", "--cache-file"}, options);
+        if (argc < 4 || !parsed) {
+            std::cerr << "Usage: " << argv[0] << " " << argv[1]
+                      << " <input.csv> <output.csv> [--threads N] [--chunk N] [--stats N] [--fixed-point]"
+                      << (batch ? " [--columnar]\n" : " [--cache N] [--cache-file F]\n");
+            return 1;
+        }
+        std::unique_ptr<TaxCache> cache = openTaxCache(options);
+        std::unique_ptr<PeriodicStatsDump> stats;
+        if (options.statsInterval > 0) {
+            stats.reset(new PeriodicStatsDump(stderr, std::chrono::seconds(options.statsInterval)));
+        }
+        std::string mode = argv[1];
+        int rejected = mode == "--batch" ? runBatchAssessment(argv[2], argv[3], options)
+                     : mode == "--households" ? runHouseholdBatch(argv[2], argv[3], options)
+                     : runReliefBatch(argv[2], argv[3], options);
+        closeTaxCache(cache, options);
+        return rejected == 0 ? 0 : 1;
+    }
+
     std::string name1, icNo1, name2, icNo2;
     double income1, income2;
     int assessmentChoice;
@@ -365,12 +937,41 @@ int main() {
         std::cin >> amount;
         std::cin.ignore(); // Clear the input buffer
 
-        expenses.push_back({category, description, amount});
+        ExpenseCategory id = findExpenseCategory(category);
+        if (id == ExpenseCategory::UNKNOWN) {
+            std::cerr << "Category '" << category << "' is not allowed as per tax laws.\n";
+            continue;
+        }
+        expenses.push_back({id, description, amount});
     }
 
     // Compare assessments
     if (assessmentChoice == 2) {
-        compareAssessments(name1, icNo1, income1, name2, icNo2, income2, expenses, "comparison.txt");
+        // Reliefs either spouse may claim; the comparison finds the best split
+        std::vector<ReliefClaim> reliefs;
+        std::cout << "Enter transferable reliefs (0 to finish):\n";
+        for (int i = 0; i < RELIEF_CATEGORY_COUNT; i++) {
+            if (RELIEF_TRANSFERABLE[i]) {
+                std::cout << i + 1 << ". " << RELIEF_CATEGORIES[i] << " (max RM " << RELIEF_MAX_DEDUCTIONS[i]
+                          << " each)\n";
+            }
+        }
+        while (true) {
+            int number;
+            double amount;
+            std::cout << "Relief number (or 0): ";
+            if (!(std::cin >> number) || number == 0) break;
+            if (number < 1 || number > RELIEF_CATEGORY_COUNT || !RELIEF_TRANSFERABLE[number - 1]) {
+                std::cerr << "Relief " << number << " cannot be shared between spouses.\n";
+                continue;
+            }
+            std::cout << "Amount (RM): ";
+            std::cin >> amount;
+            reliefs.push_back({number - 1, amount});
+        }
+        std::cin.ignore(); // Clear the input buffer
+
+        compareAssessments(name1, icNo1, income1, name2, icNo2, income2, expenses, reliefs, "comparison.txt");
     } else {
         // Individual Assessment only
         TaxCalculator individual(name1, icNo1, AssessmentType::INDIVIDUAL);
@@ -0,0 +1,100 @@
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Read-only memory mapping of a whole file.
+// Views handed out by text() stay valid until the MappedFile is closed or destroyed.
+class MappedFile {
+public:
+    MappedFile() : data(nullptr), length(0) {}
+
+    ~MappedFile() {
+        close();
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename) {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize)) {
+            CloseHandle(file);
+            return false;
+        }
+        length = static_cast<std::size_t>(fileSize.QuadPart);
+        if (length > 0) {
+            HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping != nullptr) {
+                data = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0) {
+            ::close(fd);
+            return false;
+        }
+        length = static_cast<std::size_t>(info.st_size);
+        if (length > 0) {
+            void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                data = static_cast<const char*>(address);
+                madvise(address, length, MADV_SEQUENTIAL);
+            }
+        }
+        ::close(fd);
+#endif
+        if (length > 0 && data == nullptr) {
+            length = 0;
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (data != nullptr) {
+#ifdef _WIN32
+            UnmapViewOfFile(data);
+#else
+            munmap(const_cast<char*>(data), length);
+#endif
+        }
+        data = nullptr;
+        length = 0;
+    }
+
+    std::string_view text() const {
+        return std::string_view(data, length);
+    }
+
+private:
+    const char* data;
+    std::size_t length;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef NET_INCOME_HPP
+#define NET_INCOME_HPP
+
+#include <limits>
+#include "tax_schedule.hpp"
+
+// Inverse of the tax schedule: the gross income that leaves a given
+// after-tax income. After-tax income is
+//   net(x) = x - T(x)
+// in terms of taxable income x. Within bracket k it rises with slope
+// 1 - rates[k] > 0, so it is strictly increasing and piecewise linear with
+// breakpoints net(thresholds[k]) = thresholds[k] - bases[k]. Those
+// breakpoints are precomputed, so a query is one bracket lookup (same
+// branch-free count as TaxSchedule::bracketIndex) and one division.
+struct NetIncomeSchedule {
+    int count;
+    double netThresholds[TaxSchedule::MAX_BRACKETS]; // after-tax income at each threshold
+    double thresholds[TaxSchedule::MAX_BRACKETS];
+    double keepRates[TaxSchedule::MAX_BRACKETS];     // 1 - rates[k]
+
+    // Taxable income whose after-tax income is 'netIncome'
+    constexpr double taxableIncomeFor(double netIncome) const {
+        int k = 0;
+        for (int i = 1; i < TaxSchedule::MAX_BRACKETS; i++) {
+            k += netIncome > netThresholds[i];
+        }
+        return thresholds[k] + (netIncome - netThresholds[k]) / keepRates[k];
+    }
+};
+
+constexpr NetIncomeSchedule toNetIncomeSchedule(const TaxSchedule& schedule) {
+    NetIncomeSchedule inverse = {schedule.count, {}, {}, {}};
+    for (int i = 0; i < TaxSchedule::MAX_BRACKETS; i++) {
+        bool used = i < schedule.count;
+        inverse.netThresholds[i] = used ? schedule.thresholds[i] - schedule.bases[i]
+                                        : std::numeric_limits<double>::infinity();
+        inverse.thresholds[i] = schedule.thresholds[i];
+        inverse.keepRates[i] = used ? 1 - schedule.rates[i] : 1;
+    }
+    return inverse;
+}
+
+constexpr NetIncomeSchedule INDIVIDUAL_NET_SCHEDULE = toNetIncomeSchedule(INDIVIDUAL_SCHEDULE);
+constexpr NetIncomeSchedule JOINT_NET_SCHEDULE = toNetIncomeSchedule(JOINT_SCHEDULE);
+constexpr NetIncomeSchedule SOLE_PROPRIETOR_NET_SCHEDULE = toNetIncomeSchedule(SOLE_PROPRIETOR_SCHEDULE);
+
+constexpr const NetIncomeSchedule& netScheduleFor(AssessmentType type) {
+    return type == AssessmentType::JOINT ? JOINT_NET_SCHEDULE
+         : type == AssessmentType::SOLE_PROPRIETOR ? SOLE_PROPRIETOR_NET_SCHEDULE : INDIVIDUAL_NET_SCHEDULE;
+}
+
+// Gross income needed to keep 'targetNetIncome' after tax, given 'deductions'.
+// Deductions lower taxable income but not take-home pay, so
+//   targetNetIncome = gross - T(gross - deductions)
+constexpr double requiredGrossIncome(AssessmentType type, double targetNetIncome, double deductions = 0) {
+    return deductions + netScheduleFor(type).taxableIncomeFor(targetNetIncome - deductions);
+}
+
+static_assert(requiredGrossIncome(AssessmentType::INDIVIDUAL, 100000 - evaluateTax(AssessmentType::INDIVIDUAL, 90000), 10000) == 100000,
+              "Net income inverse broken");
+static_assert(requiredGrossIncome(AssessmentType::SOLE_PROPRIETOR, 200000 - evaluateTax(AssessmentType::SOLE_PROPRIETOR, 200000)) == 200000,
+              "Net income inverse broken");
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef RECORD_READER_HPP
+#define RECORD_READER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+// Zero-copy helpers for parsing delimited text held in memory (usually a
+// MappedFile). Every field is a std::string_view into the original text.
+
+// Splits text into lines, dropping a trailing '\r'
+class LineReader {
+public:
+    explicit LineReader(std::string_view text) : text(text), position(0), lineNo(0) {}
+
+    bool next(std::string_view& line) {
+        if (position >= text.size()) {
+            return false;
+        }
+        std::size_t end = text.find('\n', position);
+        if (end == std::string_view::npos) {
+            end = text.size();
+        }
+        line = text.substr(position, end - position);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        position = end + 1;
+        ++lineNo;
+        return true;
+    }
+
+    // Number of the line last returned by next(), starting at 1
+    long lineNumber() const {
+        return lineNo;
+    }
+
+private:
+    std::string_view text;
+    std::size_t position;
+    long lineNo;
+};
+
+// Split 'text' on 'separator' into 'fields' (reusing its storage)
+inline void splitFields(std::string_view text, char separator, std::vector<std::string_view>& fields) {
+    fields.clear();
+    std::size_t start = 0;
+    while (true) {
+        std::size_t end = text.find(separator, start);
+        if (end == std::string_view::npos) {
+            fields.push_back(text.substr(start));
+            return;
+        }
+        fields.push_back(text.substr(start, end - start));
+        start = end + 1;
+    }
+}
+
+// Largest amount, in RM, accepted from input; anything bigger is a typo or
+// garbage. Sums of many amounts can still exceed it: the fixed-point mode
+// saturates them at SEN_LIMIT (fixed_point.hpp).
+const double MAX_AMOUNT = 1e12;
+
+// Whole-field decimal number, no locale and no allocation. Rejects "nan",
+// "inf" and anything outside [-MAX_AMOUNT, MAX_AMOUNT].
+inline bool parseAmount(std::string_view text, double& amount) {
+    if (text.empty()) {
+        return false;
+    }
+    const char* end = text.data() + text.size();
+    double value;
+    std::from_chars_result parsed = std::from_chars(text.data(), end, value);
+    if (parsed.ec != std::errc() || parsed.ptr != end || !(value >= -MAX_AMOUNT && value <= MAX_AMOUNT)) {
+        return false;
+    }
+    amount = value;
+    return true;
+}
+
+// Whole-field decimal integer, such as a count given on the command line
+inline bool parseCount(std::string_view text, long& count) {
+    const char* end = text.data() + text.size();
+    long value;
+    std::from_chars_result parsed = std::from_chars(text.data(), end, value);
+    if (text.empty() || parsed.ec != std::errc() || parsed.ptr != end) {
+        return false;
+    }
+    count = value;
+    return true;
+}
+
+#endif
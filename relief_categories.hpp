@@ -0,0 +1,71 @@
+#ifndef RELIEF_CATEGORIES_HPP
+#define RELIEF_CATEGORIES_HPP
+
+#include <string_view>
+
+// The 23 personal relief categories used by the relief selection
+// (Selection Expenses V4), with their maximum deductions in RM.
+const int RELIEF_CATEGORY_COUNT = 23;
+
+// Maximum deductions for each expense category
+constexpr int RELIEF_MAX_DEDUCTIONS[RELIEF_CATEGORY_COUNT] = {
+    9000,  // 1. Individual and dependent relatives
+    8000,  // 2. Expenses for parents (medical, dental, etc.)
+    6000,  // 3. Purchase of basic supporting equipment for disabled
+    6000,  // 4. Disabled individual
+    7000,  // 5. Education fees (self)
+    10000, // 6. Medical expenses (serious diseases, fertility, etc.)
+    1000,  // 7. Expenses (medical examination, COVID-19, mental health)
+    4000,  // 8. Expenses for child (intellectual disability, early intervention)
+    2500,  // 9. Lifestyle (books, computers, internet, courses)
+    1000,  // 10. Lifestyle (sports equipment, gym membership)
+    1000,  // 11. Breastfeeding equipment
+    3000,  // 12. Child care fees
+    8000,  // 13. Skim Simpanan Pendidikan Nasional
+    4000,  // 14. Husband/wife/alimony
+    5000,  // 15. Disabled husband/wife
+    2000,  // 16. Unmarried child under 18
+    2000,  // 17. Unmarried child 18+ (A-Level, diploma, etc.)
+    6000,  // 18. Disabled child
+    7000,  // 19. Life insurance and EPF
+    3000,  // 20. Deferred Annuity and PRS
+    3000,  // 21. Education and medical insurance
+    350,   // 22. SOCSO contribution
+    2500   // 23. Electric vehicle charging facilities
+};
+
+// Reliefs either spouse may claim for the household: parents, spouse and children
+constexpr bool RELIEF_TRANSFERABLE[RELIEF_CATEGORY_COUNT] = {
+    false, true,  false, false, false, false, false, true,  // 1-8
+    false, false, false, true,  false, true,  true,  true,  // 9-16
+    true,  true,  false, false, false, false, false         // 17-23
+};
+
+// Array of category descriptions
+constexpr std::string_view RELIEF_CATEGORIES[RELIEF_CATEGORY_COUNT] = {
+    "individual and dependent relatives",
+    "expenses for parents (medical, dental, etc.)",
+    "purchase of basic supporting equipment for disabled",
+    "disabled individual",
+    "education fees (self)",
+    "medical expenses (serious diseases, fertility, etc.)",
+    "expenses (medical examination, COVID-19, mental health)",
+    "expenses for child (intellectual disability, early intervention)",
+    "lifestyle (books, computers, internet, courses)",
+    "lifestyle (sports equipment, gym membership)",
+    "breastfeeding equipment",
+    "child care fees",
+    "Skim Simpanan Pendidikan Nasional",
+    "husband/wife/alimony",
+    "disabled husband/wife",
+    "unmarried child under 18",
+    "unmarried child 18+ (A-Level, diploma, etc.)",
+    "disabled child",
+    "life insurance and EPF",
+    "deferred annuity or PRS",
+    "education or medical insurance",
+    "SOCSO contributions",
+    "electric vehicle charging facilities"
+};
+
+#endif
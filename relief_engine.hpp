@@ -0,0 +1,234 @@
+#ifndef RELIEF_ENGINE_HPP
+#define RELIEF_ENGINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "relief_categories.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RELIEF_ENGINE_X86 1
+#include <immintrin.h>
+#endif
+
+// Batched relief capping for the 23 relief categories.
+// Each claim row holds one answer per category (an amount in RM, or a
+// number of children for the per-child reliefs), padded to 24 columns so a
+// row is exactly three 8-lane or six 4-lane vectors. Every cell becomes
+//   min(max(answer, 0), limit) * unit & eligible
+// where the eligibility mask depends on marital status and children, and
+// the row total is what calculateTotalDeductible() returns for that row.
+// Answers are clamped before the multiply, so no cell and no row total can
+// overflow int32 whatever the answers are.
+
+const int RELIEF_COLUMNS = 24;
+
+// Which questions apply: single, married (or divorced) without and with children
+enum class ReliefProfile : std::uint8_t { SINGLE, MARRIED, MARRIED_WITH_CHILDREN };
+
+const int RELIEF_PROFILE_COUNT = 3;
+
+inline ReliefProfile reliefProfile(bool married, bool hasChildren) {
+    return !married ? ReliefProfile::SINGLE
+         : hasChildren ? ReliefProfile::MARRIED_WITH_CHILDREN : ReliefProfile::MARRIED;
+}
+
+// Amount per unit answered: 1 for RM amounts, per child for 16-18
+constexpr std::int32_t RELIEF_UNIT_AMOUNTS[RELIEF_COLUMNS] = {
+    1, 1, 1, 1, 1, 1, 1, 1,       // 1-8
+    1, 1, 1, 1, 1, 1, 1, 2000,    // 9-16
+    2000, 6000, 1, 1, 1, 1, 1, 0  // 17-23, padding
+};
+
+// Most children counted for one per-child relief
+const std::int32_t RELIEF_MAX_CHILDREN = 99;
+
+// Largest answer that counts per category: the cap for RM amounts (unit 1),
+// RELIEF_MAX_CHILDREN for the per-child reliefs
+constexpr std::int32_t RELIEF_ANSWER_LIMITS[RELIEF_COLUMNS] = {
+    RELIEF_MAX_DEDUCTIONS[0], RELIEF_MAX_DEDUCTIONS[1], RELIEF_MAX_DEDUCTIONS[2], RELIEF_MAX_DEDUCTIONS[3],
+    RELIEF_MAX_DEDUCTIONS[4], RELIEF_MAX_DEDUCTIONS[5], RELIEF_MAX_DEDUCTIONS[6], RELIEF_MAX_DEDUCTIONS[7],
+    RELIEF_MAX_DEDUCTIONS[8], RELIEF_MAX_DEDUCTIONS[9], RELIEF_MAX_DEDUCTIONS[10], RELIEF_MAX_DEDUCTIONS[11],
+    RELIEF_MAX_DEDUCTIONS[12], RELIEF_MAX_DEDUCTIONS[13], RELIEF_MAX_DEDUCTIONS[14], RELIEF_MAX_CHILDREN,
+    RELIEF_MAX_CHILDREN, RELIEF_MAX_CHILDREN, RELIEF_MAX_DEDUCTIONS[18], RELIEF_MAX_DEDUCTIONS[19],
+    RELIEF_MAX_DEDUCTIONS[20], RELIEF_MAX_DEDUCTIONS[21], RELIEF_MAX_DEDUCTIONS[22], 0
+};
+
+// Largest possible row total, so int32 totals cannot overflow
+constexpr long long maxReliefRowTotal() {
+    long long total = 0;
+    for (int c = 0; c < RELIEF_COLUMNS; c++) {
+        total += static_cast<long long>(RELIEF_ANSWER_LIMITS[c]) * RELIEF_UNIT_AMOUNTS[c];
+    }
+    return total;
+}
+
+static_assert(maxReliefRowTotal() <= INT32_MAX, "Relief row totals may overflow int32");
+
+// All ones where a profile may claim the category
+constexpr std::int32_t RELIEF_ELIGIBLE[RELIEF_PROFILE_COUNT][RELIEF_COLUMNS] = {
+    // Single: no child or spouse reliefs (8, 12, 14-18)
+    {-1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1, 0, -1, 0, 0, 0, 0, 0, -1, -1, -1, -1, -1, 0},
+    // Married without children: no child reliefs (8, 12, 16-18)
+    {-1, -1, -1, -1, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, 0, 0, -1, -1, -1, -1, -1, 0},
+    // Married with children: every category
+    {-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0}
+};
+
+constexpr bool isReliefEligible(ReliefProfile profile, int category) {
+    return RELIEF_ELIGIBLE[static_cast<int>(profile)][category] != 0;
+}
+
+// One capped cell, as the engine computes it
+constexpr std::int32_t capRelief(ReliefProfile profile, int category, std::int32_t answer) {
+    std::int32_t counted = answer > 0 ? answer : 0;
+    counted = counted < RELIEF_ANSWER_LIMITS[category] ? counted : RELIEF_ANSWER_LIMITS[category];
+    return counted * RELIEF_UNIT_AMOUNTS[category] & RELIEF_ELIGIBLE[static_cast<int>(profile)][category];
+}
+
+static_assert(capRelief(ReliefProfile::SINGLE, 0, 12000) == 9000, "Relief capping broken");
+static_assert(capRelief(ReliefProfile::MARRIED_WITH_CHILDREN, 17, 2) == 12000, "Relief capping broken");
+static_assert(capRelief(ReliefProfile::MARRIED, 15, 2) == 0, "Relief capping broken");
+static_assert(capRelief(ReliefProfile::MARRIED_WITH_CHILDREN, 17, 400000) == RELIEF_MAX_CHILDREN * 6000 &&
+              capRelief(ReliefProfile::MARRIED_WITH_CHILDREN, 15, INT32_MAX) == RELIEF_MAX_CHILDREN * 2000 &&
+              capRelief(ReliefProfile::SINGLE, 0, INT32_MAX) == 9000 &&
+              capRelief(ReliefProfile::SINGLE, 0, INT32_MIN) == 0, "Relief capping overflows");
+
+inline void capReliefsScalar(const std::int32_t* claims, const ReliefProfile* profiles,
+                             std::int32_t* capped, std::int32_t* totals, std::size_t rows) {
+    for (std::size_t r = 0; r < rows; r++) {
+        const std::int32_t* claim = claims + r * RELIEF_COLUMNS;
+        std::int32_t* out = capped + r * RELIEF_COLUMNS;
+        std::int32_t total = 0;
+        for (int c = 0; c < RELIEF_COLUMNS; c++) {
+            out[c] = capRelief(profiles[r], c, claim[c]);
+            total += out[c];
+        }
+        totals[r] = total;
+    }
+}
+
+#ifdef RELIEF_ENGINE_X86
+// SSE4.1: six 4-lane steps per row
+__attribute__((target("sse4.1")))
+inline void capReliefsSSE41(const std::int32_t* claims, const ReliefProfile* profiles,
+                            std::int32_t* capped, std::int32_t* totals, std::size_t rows) {
+    const __m128i zero = _mm_setzero_si128();
+    for (std::size_t r = 0; r < rows; r++) {
+        const std::int32_t* eligible = RELIEF_ELIGIBLE[static_cast<int>(profiles[r])];
+        __m128i sum = zero;
+        for (int c = 0; c < RELIEF_COLUMNS; c += 4) {
+            __m128i claim = _mm_loadu_si128(reinterpret_cast<const __m128i*>(claims + r * RELIEF_COLUMNS + c));
+            __m128i counted = _mm_min_epi32(_mm_max_epi32(claim, zero),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(RELIEF_ANSWER_LIMITS + c)));
+            __m128i amount = _mm_mullo_epi32(counted,
+                                             _mm_loadu_si128(reinterpret_cast<const __m128i*>(RELIEF_UNIT_AMOUNTS + c)));
+            amount = _mm_and_si128(amount, _mm_loadu_si128(reinterpret_cast<const __m128i*>(eligible + c)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(capped + r * RELIEF_COLUMNS + c), amount);
+            sum = _mm_add_epi32(sum, amount);
+        }
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+        sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+        totals[r] = _mm_cvtsi128_si32(sum);
+    }
+}
+
+// AVX2: three 8-lane steps per row
+__attribute__((target("avx2")))
+inline void capReliefsAVX2(const std::int32_t* claims, const ReliefProfile* profiles,
+                           std::int32_t* capped, std::int32_t* totals, std::size_t rows) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i units[3] = {
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(RELIEF_UNIT_AMOUNTS)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(RELIEF_UNIT_AMOUNTS + 8)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(RELIEF_UNIT_AMOUNTS + 16))
+    };
+    const __m256i limits[3] = {
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(RELIEF_ANSWER_LIMITS)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(RELIEF_ANSWER_LIMITS + 8)),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(RELIEF_ANSWER_LIMITS + 16))
+    };
+    for (std::size_t r = 0; r < rows; r++) {
+        const std::int32_t* eligible = RELIEF_ELIGIBLE[static_cast<int>(profiles[r])];
+        __m256i sum = zero;
+        for (int v = 0; v < 3; v++) {
+            __m256i claim = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(claims + r * RELIEF_COLUMNS + 8 * v));
+            __m256i counted = _mm256_min_epi32(_mm256_max_epi32(claim, zero), limits[v]);
+            __m256i amount = _mm256_mullo_epi32(counted, units[v]);
+            amount = _mm256_and_si256(amount, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(eligible + 8 * v)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(capped + r * RELIEF_COLUMNS + 8 * v), amount);
+            sum = _mm256_add_epi32(sum, amount);
+        }
+        __m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+        half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+        totals[r] = _mm_cvtsi128_si32(half);
+    }
+}
+#endif
+
+// Caps 'rows' claim rows (RELIEF_COLUMNS each) into 'capped' and writes each row's
+// total to 'totals'. Picks the widest instruction set the CPU supports at run time.
+inline void capReliefs(const std::int32_t* claims, const ReliefProfile* profiles,
+                       std::int32_t* capped, std::int32_t* totals, std::size_t rows) {
+#ifdef RELIEF_ENGINE_X86
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    static const bool hasSSE41 = __builtin_cpu_supports("sse4.1");
+    if (hasAVX2) {
+        capReliefsAVX2(claims, profiles, capped, totals, rows);
+        return;
+    }
+    if (hasSSE41) {
+        capReliefsSSE41(claims, profiles, capped, totals, rows);
+        return;
+    }
+#endif
+    capReliefsScalar(claims, profiles, capped, totals, rows);
+}
+
+// Growable batch of claim rows with their capped matrix and totals
+class ReliefBatch {
+public:
+    // Starts a zeroed claim row for 'profile' and returns it for filling in
+    std::int32_t* addRow(ReliefProfile profile) {
+        profiles.push_back(profile);
+        claims.resize(claims.size() + RELIEF_COLUMNS, 0);
+        return claims.data() + claims.size() - RELIEF_COLUMNS;
+    }
+
+    void clear() {
+        profiles.clear();
+        claims.clear();
+    }
+
+    std::size_t size() const {
+        return profiles.size();
+    }
+
+    ReliefProfile profile(std::size_t row) const {
+        return profiles[row];
+    }
+
+    void calculate() {
+        capped.resize(claims.size());
+        totals.resize(profiles.size());
+        capReliefs(claims.data(), profiles.data(), capped.data(), totals.data(), profiles.size());
+    }
+
+    // Valid after calculate()
+    const std::int32_t* cappedRow(std::size_t row) const {
+        return capped.data() + row * RELIEF_COLUMNS;
+    }
+
+    std::int32_t total(std::size_t row) const {
+        return totals[row];
+    }
+
+private:
+    std::vector<ReliefProfile> profiles;
+    std::vector<std::int32_t> claims;
+    std::vector<std::int32_t> capped;
+    std::vector<std::int32_t> totals;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef RELIEF_OPTIMIZER_HPP
+#define RELIEF_OPTIMIZER_HPP
+
+#include <cstddef>
+#include "relief_categories.hpp"
+#include "relief_engine.hpp"
+#include "tax_schedule.hpp"
+
+// Splits transferable reliefs (parents, spouse, children) between two
+// spouses assessed individually so that their combined tax is lowest.
+//
+// Each spouse may claim up to the category maximum, so per category the
+// household can claim min(amount, 2 * maximum), and spouse 1's share lies in
+// [claimed - min(claimed, maximum), min(claimed, maximum)]. The maximum of a
+// per-child relief (16-18) is RELIEF_MAX_CHILDREN children's worth, as in
+// relief_engine.hpp, so both paths cap claims alike. Combined tax only
+// depends on the total a given to spouse 1:
+//   f(a) = T(taxable1 - a) + T(taxable2 - claimed + a)
+// f is piecewise linear and only changes slope where one spouse crosses a
+// bracket threshold, so its minimum over [low, high] lies at an end of the
+// interval or at one of those crossings: 2 + 2 * brackets evaluations,
+// then one pass over the categories to hand out a.
+
+struct ReliefClaim {
+    int category;  // index into RELIEF_CATEGORIES; must be RELIEF_TRANSFERABLE
+    double amount; // spent by the household
+};
+
+struct ReliefSplit {
+    double claimed;   // transferable relief the household can claim in total
+    double toSpouse1;
+    double toSpouse2;
+    double tax1;
+    double tax2;
+    double totalTax;
+};
+
+// Most one spouse may claim in 'category': the largest answer relief_engine.hpp
+// counts, times its unit amount
+inline double spouseReliefCap(int category) {
+    return static_cast<double>(RELIEF_ANSWER_LIMITS[category]) * RELIEF_UNIT_AMOUNTS[category];
+}
+
+// Tax on taxable income, with negative income taxed as zero
+inline double taxOnTaxable(const TaxSchedule& schedule, double taxableIncome) {
+    return schedule.evaluate(taxableIncome > 0 ? taxableIncome : 0);
+}
+
+// Best split of 'claims' for spouses with the given taxable incomes (before
+// these reliefs). If 'shares1' is given, spouse 1's share of each claim is
+// written to it; spouse 2 takes the rest of what can be claimed.
+inline ReliefSplit optimizeReliefSplit(const TaxSchedule& schedule, double taxable1, double taxable2,
+                                       const ReliefClaim* claims, std::size_t count, double* shares1 = nullptr) {
+    double claimed = 0, low = 0, high = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        double cap = spouseReliefCap(claims[i].category);
+        double amount = claims[i].amount < 2 * cap ? claims[i].amount : 2 * cap;
+        double most = amount < cap ? amount : cap;
+        claimed += amount;
+        low += amount - most;
+        high += most;
+    }
+
+    double rest2 = taxable2 - claimed;
+    auto combinedTax = [&](double a) {
+        return taxOnTaxable(schedule, taxable1 - a) + taxOnTaxable(schedule, rest2 + a);
+    };
+
+    double best = low;
+    double bestTax = combinedTax(low);
+    auto consider = [&](double a) {
+        if (a > low && a <= high) {
+            double tax = combinedTax(a);
+            if (tax < bestTax) {
+                best = a;
+                bestTax = tax;
+            }
+        }
+    };
+    consider(high);
+    for (int k = 0; k < schedule.count; k++) {
+        consider(taxable1 - schedule.thresholds[k]); // spouse 1 lands on threshold k
+        consider(schedule.thresholds[k] - rest2);    // spouse 2 lands on threshold k
+    }
+
+    if (shares1 != nullptr) {
+        double remaining = best - low;
+        for (std::size_t i = 0; i < count; i++) {
+            double cap = spouseReliefCap(claims[i].category);
+            double amount = claims[i].amount < 2 * cap ? claims[i].amount : 2 * cap;
+            double most = amount < cap ? amount : cap;
+            double extra = remaining < 2 * most - amount ? remaining : 2 * most - amount;
+            shares1[i] = amount - most + extra;
+            remaining -= extra;
+        }
+    }
+
+    ReliefSplit split;
+    split.claimed = claimed;
+    split.toSpouse1 = best;
+    split.toSpouse2 = claimed - best;
+    split.tax1 = taxOnTaxable(schedule, taxable1 - best);
+    split.tax2 = taxOnTaxable(schedule, rest2 + best);
+    split.totalTax = split.tax1 + split.tax2;
+    return split;
+}
+
+// Naive split for comparison: spouse 1 claims each relief up to its maximum
+// and spouse 2 claims whatever is left.
+inline ReliefSplit firstSpouseReliefSplit(const TaxSchedule& schedule, double taxable1, double taxable2,
+                                          const ReliefClaim* claims, std::size_t count) {
+    double claimed = 0, high = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        double cap = spouseReliefCap(claims[i].category);
+        double amount = claims[i].amount < 2 * cap ? claims[i].amount : 2 * cap;
+        claimed += amount;
+        high += amount < cap ? amount : cap;
+    }
+    ReliefSplit split;
+    split.claimed = claimed;
+    split.toSpouse1 = high;
+    split.toSpouse2 = claimed - high;
+    split.tax1 = taxOnTaxable(schedule, taxable1 - high);
+    split.tax2 = taxOnTaxable(schedule, taxable2 - split.toSpouse2);
+    split.totalTax = split.tax1 + split.tax2;
+    return split;
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef RELIEF_TAX_HPP
+#define RELIEF_TAX_HPP
+
+#include <cstdint>
+#include "fixed_point.hpp"
+#include "instrumentation.hpp"
+#include "relief_engine.hpp"
+#include "tax_cache.hpp"
+#include "tax_schedule.hpp"
+
+// Fused relief-to-tax assessment: raw relief answers go through the V4
+// caps (relief_engine.hpp) and the capped total is subtracted from income
+// and fed straight into the bracket evaluation. Nothing is materialized in
+// between: no Expense objects, no per-category strings, no TaxCalculator.
+
+struct ReliefTaxAssessment {
+    double totalIncome;
+    double totalRelief;
+    double taxableIncome;
+    double tax;
+};
+
+// 'claims' holds RELIEF_COLUMNS raw answers (RM amounts, or numbers of
+// children for the per-child reliefs); the padding column must be zero.
+inline ReliefTaxAssessment assessWithReliefs(AssessmentType type, ReliefProfile profile, double totalIncome,
+                                             const std::int32_t* claims,
+                                             ArithmeticMode mode = ArithmeticMode::FLOATING_POINT) {
+    std::int32_t capped[RELIEF_COLUMNS];
+    std::int32_t totalRelief;
+    {
+        TAX_STAGE_TIMER(Stage::RELIEF_CAPPING);
+        capReliefs(claims, &profile, capped, &totalRelief, 1);
+    }
+
+    TAX_STAGE_TIMER(Stage::BRACKET_EVALUATION);
+    ReliefTaxAssessment result;
+    result.totalRelief = totalRelief;
+    if (mode == ArithmeticMode::FIXED_POINT) {
+        Sen income = toSen(totalIncome);
+        Sen taxable = income - static_cast<Sen>(totalRelief) * 100;
+        result.totalIncome = toRinggit(income);
+        result.taxableIncome = toRinggit(taxable);
+        result.tax = toRinggit(evaluateTaxSenCached(type, taxable));
+    } else {
+        result.totalIncome = totalIncome;
+        result.taxableIncome = totalIncome - totalRelief;
+        result.tax = evaluateTaxCached(type, result.taxableIncome);
+    }
+    return result;
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef REPORT_BUFFER_HPP
+#define REPORT_BUFFER_HPP
+
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+// Reusable output buffer for reports and result files.
+// Text is appended into one growing byte buffer; numbers are formatted
+// with std::to_chars (no locale, amounts always with 2 decimals) and
+// column padding is copied from a static run of spaces. When a file is
+// attached the buffer is written out in large blocks; without a file it
+// simply accumulates, and view() returns everything written so far.
+// A failed write is remembered until the next open() or attach(), so an
+// error during an automatic flush is still reported by close().
+class ReportBuffer {
+public:
+    explicit ReportBuffer(std::size_t flushThreshold = 1 << 16)
+        : file(nullptr), ownsFile(false), failed(false), threshold(flushThreshold) {
+        buffer.reserve(flushThreshold + 512);
+    }
+
+    ~ReportBuffer() {
+        close();
+    }
+
+    ReportBuffer(const ReportBuffer&) = delete;
+    ReportBuffer& operator=(const ReportBuffer&) = delete;
+
+    // Writes to 'filename' (truncating it) until close()
+    bool open(const std::string& filename) {
+        close();
+        file = std::fopen(filename.c_str(), "wb");
+        ownsFile = file != nullptr;
+        failed = false;
+        return file != nullptr;
+    }
+
+    // Writes to an already open stream such as stdout; the caller keeps ownership
+    void attach(std::FILE* stream) {
+        close();
+        file = stream;
+        ownsFile = false;
+        failed = false;
+    }
+
+    // Flushes and releases the file; returns false if any write since
+    // open() or attach() failed
+    bool close() {
+        flush();
+        if (file != nullptr && (ownsFile ? std::fclose(file) : std::fflush(file)) != 0) {
+            failed = true;
+        }
+        file = nullptr;
+        ownsFile = false;
+        return !failed;
+    }
+
+    // Returns false if this or any earlier write failed
+    bool flush() {
+        if (file != nullptr && !buffer.empty()) {
+            failed = std::fwrite(buffer.data(), 1, buffer.size(), file) != buffer.size() || failed;
+            buffer.clear();
+        }
+        return !failed;
+    }
+
+    void clear() {
+        buffer.clear();
+    }
+
+    std::string_view view() const {
+        return buffer;
+    }
+
+    ReportBuffer& append(std::string_view text) {
+        buffer.append(text.data(), text.size());
+        flushIfFull();
+        return *this;
+    }
+
+    ReportBuffer& append(char c) {
+        buffer.push_back(c);
+        flushIfFull();
+        return *this;
+    }
+
+    // Text left-aligned in a column of 'width' characters (like std::left << std::setw)
+    ReportBuffer& appendPadded(std::string_view text, std::size_t width) {
+        buffer.append(text.data(), text.size());
+        pad(text.size(), width);
+        flushIfFull();
+        return *this;
+    }
+
+    // Amount with exactly 2 decimals, left-aligned in 'width' characters
+    ReportBuffer& appendAmount(double amount, std::size_t width = 0) {
+        return appendFixed(amount, 2, width);
+    }
+
+    // Number with exactly 'decimals' decimals, left-aligned in 'width' characters
+    ReportBuffer& appendFixed(double value, int decimals, std::size_t width = 0) {
+        char digits[400];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value,
+                                                    std::chars_format::fixed, decimals);
+        return appendPadded(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)), width);
+    }
+
+    ReportBuffer& appendInteger(long long value, std::size_t width = 0) {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        return appendPadded(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)), width);
+    }
+
+    ReportBuffer& appendUnsigned(unsigned long long value, std::size_t width = 0) {
+        char digits[24];
+        std::to_chars_result result = std::to_chars(digits, digits + sizeof(digits), value);
+        return appendPadded(std::string_view(digits, static_cast<std::size_t>(result.ptr - digits)), width);
+    }
+
+private:
+    std::string buffer;
+    std::FILE* file;
+    bool ownsFile;
+    bool failed; // sticky: some write since open()/attach() failed
+    std::size_t threshold;
+
+    void pad(std::size_t used, std::size_t width) {
+        static const char SPACES[] = "                                                                ";
+        const std::size_t available = sizeof(SPACES) - 1;
+        while (used < width) {
+            std::size_t count = width - used < available ? width - used : available;
+            buffer.append(SPACES, count);
+            used += count;
+        }
+    }
+
+    void flushIfFull() {
+        if (file != nullptr && buffer.size() >= threshold) {
+            flush();
+        }
+    }
+};
+
+#endif
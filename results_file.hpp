@@ -0,0 +1,291 @@
+#ifndef RESULTS_FILE_HPP
+#define RESULTS_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "mapped_file.hpp"
+#include "tax_schedule.hpp"
+
+// Columnar binary file of assessment results (".tcol").
+//
+// Layout (native byte order, every section a multiple of 8 bytes):
+//   header      magic "TAXCOLS\0", uint32 version, uint32 column count,
+//               uint64 row count, uint64 row group count
+//   columns     one 32-byte descriptor per column: char name[30] (NUL padded),
+//               uint8 type (RESULT_COLUMN_*), uint8 width in bytes
+//   row groups  uint64 rows, then each column's values back to back
+//               (rows * width bytes, zero padded to a multiple of 8)
+//
+// A reader maps the file and gets typed pointers straight into each row
+// group; nothing is parsed or copied.
+
+const std::uint32_t RESULTS_FILE_VERSION = 2;
+const std::uint8_t RESULT_COLUMN_UINT64 = 0;
+const std::uint8_t RESULT_COLUMN_UINT8 = 1;
+const std::uint8_t RESULT_COLUMN_FLOAT64 = 2;
+
+struct ResultsFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t columnCount;
+    std::uint64_t rowCount;
+    std::uint64_t rowGroupCount;
+};
+
+struct ResultColumnDescriptor {
+    char name[30];
+    std::uint8_t type;
+    std::uint8_t width;
+};
+
+static_assert(sizeof(ResultsFileHeader) == 32 && sizeof(ResultColumnDescriptor) == 32, "Unexpected padding");
+
+// Columns in file order
+enum ResultColumn {
+    IC_KEY,
+    ASSESSMENT_TYPE,
+    TOTAL_INCOME,
+    TOTAL_DEDUCTIONS,
+    TAXABLE_INCOME,
+    INCOME_TAX,
+    EFFECTIVE_RATE,
+    RESULT_COLUMN_COUNT
+};
+
+const ResultColumnDescriptor RESULT_COLUMNS[RESULT_COLUMN_COUNT] = {
+    {"ic_key", RESULT_COLUMN_UINT64, 8},
+    {"assessment_type", RESULT_COLUMN_UINT8, 1},
+    {"total_income", RESULT_COLUMN_FLOAT64, 8},
+    {"total_deductions", RESULT_COLUMN_FLOAT64, 8},
+    {"taxable_income", RESULT_COLUMN_FLOAT64, 8},
+    {"income_tax", RESULT_COLUMN_FLOAT64, 8},
+    {"effective_rate", RESULT_COLUMN_FLOAT64, 8}
+};
+
+// IC number as a 64-bit key: its digits as a decimal number behind a leading
+// 1 that keeps their count, so leading zeros survive ("123456-34-4567" becomes
+// 1123456344567, "012" and "12" stay apart). Anything but digits is ignored,
+// so the same IC number written with or without dashes gets the same key.
+// IC numbers without digits, or with more than 18, fall back to an FNV-1a
+// hash with the top bit set; packed keys stay below 2 * 10^18 < 2^63, so
+// the two never collide.
+inline std::uint64_t icKey(std::string_view icNo) {
+    std::uint64_t key = 1;
+    int digits = 0;
+    for (char c : icNo) {
+        if (c >= '0' && c <= '9') {
+            key = key * 10 + static_cast<std::uint64_t>(c - '0');
+            ++digits;
+        }
+    }
+    if (digits > 0 && digits <= 18) {
+        return key;
+    }
+    std::uint64_t hash = 14695981039346656037ull;
+    for (char c : icNo) {
+        hash ^= static_cast<std::uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash | (1ull << 63);
+}
+
+struct ResultRow {
+    std::uint64_t icKey;
+    AssessmentType type;
+    double totalIncome;
+    double totalDeductions;
+    double taxableIncome;
+    double tax;
+};
+
+// Buffers rows column by column and writes one row group per 'groupRows' rows
+class ResultsFileWriter {
+public:
+    explicit ResultsFileWriter(std::size_t groupRows = 65536)
+        : file(nullptr), groupRows(groupRows), rowCount(0), rowGroupCount(0), ok(true) {}
+
+    ~ResultsFileWriter() {
+        close();
+    }
+
+    ResultsFileWriter(const ResultsFileWriter&) = delete;
+    ResultsFileWriter& operator=(const ResultsFileWriter&) = delete;
+
+    bool open(const std::string& filename) {
+        close();
+        file = std::fopen(filename.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        rowCount = 0;
+        rowGroupCount = 0;
+        ok = writeHeader();
+        return ok;
+    }
+
+    void append(const ResultRow& row) {
+        icKeys.push_back(row.icKey);
+        types.push_back(static_cast<std::uint8_t>(row.type));
+        values[0].push_back(row.totalIncome);
+        values[1].push_back(row.totalDeductions);
+        values[2].push_back(row.taxableIncome);
+        values[3].push_back(row.tax);
+        values[4].push_back(row.totalIncome > 0 ? row.tax / row.totalIncome : 0);
+        if (icKeys.size() >= groupRows) {
+            writeGroup();
+        }
+    }
+
+    // Writes the last row group and the final counts; returns false if any write failed
+    bool close() {
+        if (file == nullptr) {
+            return true;
+        }
+        writeGroup();
+        ok = ok && std::fseek(file, 0, SEEK_SET) == 0 && writeHeader();
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    std::FILE* file;
+    std::size_t groupRows;
+    std::uint64_t rowCount;
+    std::uint64_t rowGroupCount;
+    bool ok;
+    std::vector<std::uint64_t> icKeys;
+    std::vector<std::uint8_t> types;
+    std::vector<double> values[5]; // TOTAL_INCOME .. EFFECTIVE_RATE
+
+    bool writeHeader() {
+        ResultsFileHeader header = {{'T', 'A', 'X', 'C', 'O', 'L', 'S', '\0'}, RESULTS_FILE_VERSION,
+                                    RESULT_COLUMN_COUNT, rowCount, rowGroupCount};
+        return std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+               std::fwrite(RESULT_COLUMNS, sizeof(RESULT_COLUMNS), 1, file) == 1;
+    }
+
+    bool writePadded(const void* data, std::size_t bytes) {
+        static const char ZEROS[8] = {};
+        std::size_t padding = (8 - bytes % 8) % 8;
+        return (bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes) &&
+               (padding == 0 || std::fwrite(ZEROS, 1, padding, file) == padding);
+    }
+
+    void writeGroup() {
+        std::uint64_t rows = icKeys.size();
+        if (rows == 0) {
+            return;
+        }
+        ok = ok && std::fwrite(&rows, sizeof(rows), 1, file) == 1;
+        ok = ok && writePadded(icKeys.data(), rows * sizeof(std::uint64_t));
+        ok = ok && writePadded(types.data(), rows);
+        for (auto& column : values) {
+            ok = ok && writePadded(column.data(), rows * sizeof(double));
+            column.clear();
+        }
+        icKeys.clear();
+        types.clear();
+        rowCount += rows;
+        ++rowGroupCount;
+    }
+};
+
+// Typed view of one row group inside a mapped results file
+struct ResultRowGroup {
+    std::size_t rows;
+    const std::uint64_t* icKeys;
+    const std::uint8_t* types;
+    const double* totalIncome;
+    const double* totalDeductions;
+    const double* taxableIncome;
+    const double* tax;
+    const double* effectiveRate;
+};
+
+// Maps a results file and indexes its row groups
+class ResultsFileReader {
+public:
+    bool open(const std::string& filename) {
+        groups.clear();
+        if (!file.open(filename)) {
+            return false;
+        }
+        std::string_view data = file.text();
+        ResultsFileHeader header;
+        std::size_t columnsEnd = sizeof(header) + sizeof(RESULT_COLUMNS);
+        if (data.size() < columnsEnd) {
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        if (std::memcmp(header.magic, "TAXCOLS", 8) != 0 || header.version != RESULTS_FILE_VERSION ||
+            header.columnCount != RESULT_COLUMN_COUNT ||
+            std::memcmp(data.data() + sizeof(header), RESULT_COLUMNS, sizeof(RESULT_COLUMNS)) != 0) {
+            return false;
+        }
+
+        const char* base = data.data();
+        std::size_t offset = columnsEnd;
+        std::uint64_t rowsSeen = 0;
+        for (std::uint64_t g = 0; g < header.rowGroupCount; g++) {
+            std::uint64_t rows;
+            if (offset + sizeof(rows) > data.size()) {
+                return false;
+            }
+            std::memcpy(&rows, base + offset, sizeof(rows));
+            offset += sizeof(rows);
+            if (rows > data.size() || offset + groupBytes(rows) > data.size()) {
+                return false;
+            }
+
+            ResultRowGroup group;
+            group.rows = static_cast<std::size_t>(rows);
+            group.icKeys = reinterpret_cast<const std::uint64_t*>(base + offset);
+            offset += padded(rows * sizeof(std::uint64_t));
+            group.types = reinterpret_cast<const std::uint8_t*>(base + offset);
+            offset += padded(rows);
+            const double** columns[5] = {&group.totalIncome, &group.totalDeductions, &group.taxableIncome,
+                                         &group.tax, &group.effectiveRate};
+            for (const double** column : columns) {
+                *column = reinterpret_cast<const double*>(base + offset);
+                offset += padded(rows * sizeof(double));
+            }
+            groups.push_back(group);
+            rowsSeen += rows;
+        }
+        total = rowsSeen;
+        return rowsSeen == header.rowCount;
+    }
+
+    std::uint64_t rowCount() const {
+        return total;
+    }
+
+    std::size_t rowGroupCount() const {
+        return groups.size();
+    }
+
+    const ResultRowGroup& rowGroup(std::size_t index) const {
+        return groups[index];
+    }
+
+private:
+    MappedFile file;
+    std::vector<ResultRowGroup> groups;
+    std::uint64_t total = 0;
+
+    static std::size_t padded(std::uint64_t bytes) {
+        return static_cast<std::size_t>((bytes + 7) / 8 * 8);
+    }
+
+    static std::size_t groupBytes(std::uint64_t rows) {
+        return padded(rows * sizeof(std::uint64_t)) + padded(rows) + 5 * padded(rows * sizeof(double));
+    }
+};
+
+#endif
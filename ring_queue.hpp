@@ -0,0 +1,287 @@
+#ifndef RING_QUEUE_HPP
+#define RING_QUEUE_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define RING_QUEUE_PAUSE() _mm_pause()
+#else
+#define RING_QUEUE_PAUSE() ((void)0)
+#endif
+
+// Bounded lock-free ring buffers for handing work between pipeline stages.
+// Capacities are rounded up to a power of two. tryPush/tryPop never block;
+// push/pop wait (spinning briefly, yielding, then sleeping) until there is
+// room or an item, which gives the producer backpressure when its consumer
+// falls behind.
+
+// Spin, then yield: cheap when the other side answers quickly, and still
+// lets it run when both share one core. wait() returns false once the other
+// side has been slow for long enough that the caller should sleep instead.
+class Backoff {
+public:
+    bool wait() {
+        if (spins < 64) {
+            RING_QUEUE_PAUSE();
+        } else if (spins < 128) {
+            std::this_thread::yield();
+        } else {
+            return false;
+        }
+        ++spins;
+        return true;
+    }
+
+private:
+    int spins = 0;
+};
+
+// Where threads sleep until a ring changes. notify() costs one fence and one
+// load while nobody sleeps. A sleeper registers before it re-checks the ring,
+// and the other side publishes its change before it looks for sleepers, so
+// one of the two always sees the other.
+class RingWaiter {
+public:
+    // Sleeps until ready() (called under the lock) returns true
+    template <class Ready>
+    void wait(Ready ready) {
+        waiters.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, ready);
+        }
+        waiters.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            condition.notify_all();
+        }
+    }
+
+private:
+    std::atomic<int> waiters{0};
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+inline std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+
+// One producer thread, one consumer thread
+template <class T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity)
+        : mask(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1), slots(new T[mask + 1]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    bool tryPush(const T& item) {
+        if (!tryPushRaw(item)) {
+            return false;
+        }
+        notEmpty.notify();
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        if (!tryPopRaw(item)) {
+            return false;
+        }
+        notFull.notify();
+        return true;
+    }
+
+    void push(const T& item) {
+        Backoff backoff;
+        while (!tryPushRaw(item)) {
+            if (!backoff.wait()) {
+                notFull.wait([&] { return tryPushRaw(item); });
+                break;
+            }
+        }
+        notEmpty.notify();
+    }
+
+    T pop() {
+        T item;
+        Backoff backoff;
+        while (!tryPopRaw(item)) {
+            if (!backoff.wait()) {
+                notEmpty.wait([&] { return tryPopRaw(item); });
+                break;
+            }
+        }
+        notFull.notify();
+        return item;
+    }
+
+private:
+    const std::size_t mask;
+    std::unique_ptr<T[]> slots;
+    // Producer side: its index and its last view of the consumer's
+    alignas(64) std::atomic<std::size_t> tailIndex{0};
+    std::size_t headCache = 0;
+    // Consumer side
+    alignas(64) std::atomic<std::size_t> headIndex{0};
+    std::size_t tailCache = 0;
+
+    RingWaiter notEmpty;
+    RingWaiter notFull;
+
+    // The ring operations proper; the public ones add the wakeups
+    bool tryPushRaw(const T& item) {
+        std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+        if (tail - headCache > mask) {
+            headCache = headIndex.load(std::memory_order_acquire);
+            if (tail - headCache > mask) {
+                return false;
+            }
+        }
+        slots[tail & mask] = item;
+        tailIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPopRaw(T& item) {
+        std::size_t head = headIndex.load(std::memory_order_relaxed);
+        if (head == tailCache) {
+            tailCache = tailIndex.load(std::memory_order_acquire);
+            if (head == tailCache) {
+                return false;
+            }
+        }
+        item = slots[head & mask];
+        headIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+// Any number of producers and consumers. Each slot carries a sequence
+// number saying whether it is ready to be written or read in the current lap.
+template <class T>
+class MpmcRing {
+public:
+    explicit MpmcRing(std::size_t capacity)
+        : mask(roundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1), slots(new Slot[mask + 1]) {
+        for (std::size_t i = 0; i <= mask; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    bool tryPush(const T& item) {
+        if (!tryPushRaw(item)) {
+            return false;
+        }
+        notEmpty.notify();
+        return true;
+    }
+
+    bool tryPop(T& item) {
+        if (!tryPopRaw(item)) {
+            return false;
+        }
+        notFull.notify();
+        return true;
+    }
+
+    void push(const T& item) {
+        Backoff backoff;
+        while (!tryPushRaw(item)) {
+            if (!backoff.wait()) {
+                notFull.wait([&] { return tryPushRaw(item); });
+                break;
+            }
+        }
+        notEmpty.notify();
+    }
+
+    T pop() {
+        T item;
+        Backoff backoff;
+        while (!tryPopRaw(item)) {
+            if (!backoff.wait()) {
+                notEmpty.wait([&] { return tryPopRaw(item); });
+                break;
+            }
+        }
+        notFull.notify();
+        return item;
+    }
+
+private:
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        T item;
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<std::size_t> tailIndex{0};
+    alignas(64) std::atomic<std::size_t> headIndex{0};
+
+    RingWaiter notEmpty;
+    RingWaiter notFull;
+
+    // The ring operations proper; the public ones add the wakeups
+    bool tryPushRaw(const T& item) {
+        std::size_t position = tailIndex.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (lag == 0) {
+                if (tailIndex.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.item = item;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false; // full
+            } else {
+                position = tailIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool tryPopRaw(T& item) {
+        std::size_t position = headIndex.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots[position & mask];
+            std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+            if (lag == 0) {
+                if (headIndex.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    item = slot.item;
+                    slot.sequence.store(position + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (lag < 0) {
+                return false; // empty
+            } else {
+                position = headIndex.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,253 @@
+#ifndef TAX_CACHE_HPP
+#define TAX_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "fixed_point.hpp"
+#include "mapped_file.hpp"
+#include "tax_schedule.hpp"
+
+// Optional memo cache for bracket evaluations, for workloads where the same
+// taxable incomes repeat (salary bands, what-if runs).
+// Entries are keyed on the exact (schedule ID, assessment type, arithmetic
+// mode, taxable income in sen), so a hit returns exactly what the
+// evaluation would. Floating-point evaluations are only cached when the
+// taxable income is a whole number of sen; anything else bypasses the cache.
+// The cache is split into shards, each with its own lock and a fixed
+// capacity; a full shard evicts its oldest entry.
+
+struct TaxCacheKey {
+    std::uint32_t scheduleId;
+    std::uint8_t type;
+    std::uint8_t mode;
+    Sen taxableIncome;
+
+    bool operator==(const TaxCacheKey& other) const {
+        return scheduleId == other.scheduleId && type == other.type && mode == other.mode &&
+               taxableIncome == other.taxableIncome;
+    }
+};
+
+struct TaxCacheKeyHash {
+    std::size_t operator()(const TaxCacheKey& key) const {
+        // splitmix64 finalizer over the packed key
+        std::uint64_t x = static_cast<std::uint64_t>(key.taxableIncome) ^
+                          (static_cast<std::uint64_t>(key.scheduleId) << 40) ^
+                          (static_cast<std::uint64_t>(key.type) << 56) ^
+                          (static_cast<std::uint64_t>(key.mode) << 62);
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+        return static_cast<std::size_t>(x ^ (x >> 31));
+    }
+};
+
+struct TaxCacheStats {
+    std::uint64_t hits;
+    std::uint64_t misses;
+    std::uint64_t evictions;
+    std::size_t entries;
+};
+
+// One persisted entry (see TaxCache::save)
+struct TaxCacheRecord {
+    TaxCacheKey key;
+    double tax;
+};
+
+static_assert(sizeof(TaxCacheRecord) == 24, "Unexpected padding");
+
+class TaxCache {
+public:
+    static const std::size_t SHARD_COUNT = 16;
+
+    // Holds at most about 'capacity' entries
+    explicit TaxCache(std::size_t capacity)
+        : shardCapacity(capacity / SHARD_COUNT > 0 ? capacity / SHARD_COUNT : 1) {
+        for (Shard& shard : shards) {
+            shard.values.reserve(shardCapacity);
+        }
+    }
+
+    TaxCache(const TaxCache&) = delete;
+    TaxCache& operator=(const TaxCache&) = delete;
+
+    bool find(const TaxCacheKey& key, double& tax) {
+        Shard& shard = shardFor(key);
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto found = shard.values.find(key);
+            if (found != shard.values.end()) {
+                tax = found->second;
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void insert(const TaxCacheKey& key, double tax) {
+        Shard& shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!shard.values.emplace(key, tax).second) {
+            return;
+        }
+        if (shard.order.size() < shardCapacity) {
+            shard.order.push_back(key);
+            return;
+        }
+        // Full: replace the oldest entry
+        shard.values.erase(shard.order[shard.oldest]);
+        shard.order[shard.oldest] = key;
+        shard.oldest = (shard.oldest + 1) % shardCapacity;
+        evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    TaxCacheStats stats() const {
+        TaxCacheStats result = {hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed),
+                                evictions.load(std::memory_order_relaxed), 0};
+        for (const Shard& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            result.entries += shard.values.size();
+        }
+        return result;
+    }
+
+    // Writes every entry as a "TAXCACHE" header followed by TaxCacheRecords
+    bool save(const std::string& filename) const {
+        std::FILE* file = std::fopen(filename.c_str(), "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        bool ok = std::fwrite("TAXCACHE", 1, 8, file) == 8;
+        std::vector<TaxCacheRecord> records;
+        for (const Shard& shard : shards) {
+            records.clear();
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (const auto& entry : shard.values) {
+                    TaxCacheRecord record;
+                    std::memset(&record, 0, sizeof(record)); // no stray padding bytes in the file
+                    record.key.scheduleId = entry.first.scheduleId;
+                    record.key.type = entry.first.type;
+                    record.key.mode = entry.first.mode;
+                    record.key.taxableIncome = entry.first.taxableIncome;
+                    record.tax = entry.second;
+                    records.push_back(record);
+                }
+            }
+            ok = ok && (records.empty() ||
+                        std::fwrite(records.data(), sizeof(TaxCacheRecord), records.size(), file) == records.size());
+        }
+        return std::fclose(file) == 0 && ok;
+    }
+
+    // Loads entries saved by a previous run. Entries for other schedules are
+    // skipped; returns the number loaded, or -1 if the file is not a cache file.
+    long warm(const std::string& filename) {
+        MappedFile file;
+        if (!file.open(filename)) {
+            return -1;
+        }
+        std::string_view data = file.text();
+        if (data.size() < 8 || data.substr(0, 8) != "TAXCACHE" || (data.size() - 8) % sizeof(TaxCacheRecord) != 0) {
+            return -1;
+        }
+        long loaded = 0;
+        for (std::size_t offset = 8; offset < data.size(); offset += sizeof(TaxCacheRecord)) {
+            TaxCacheRecord record;
+            std::memcpy(&record, data.data() + offset, sizeof(record));
+            if (record.key.scheduleId == ACTIVE_SCHEDULE_ID) {
+                insert(record.key, record.tax);
+                ++loaded;
+            }
+        }
+        return loaded;
+    }
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<TaxCacheKey, double, TaxCacheKeyHash> values;
+        std::vector<TaxCacheKey> order; // insertion order, a ring once full
+        std::size_t oldest = 0;
+    };
+
+    std::size_t shardCapacity;
+    Shard shards[SHARD_COUNT];
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    std::atomic<std::uint64_t> evictions{0};
+
+    Shard& shardFor(const TaxCacheKey& key) {
+        return shards[(TaxCacheKeyHash()(key) >> 7) % SHARD_COUNT];
+    }
+};
+
+namespace taxcache {
+
+inline std::atomic<TaxCache*>& installed() {
+    static std::atomic<TaxCache*> cache{nullptr};
+    return cache;
+}
+
+} // namespace taxcache
+
+// Routes evaluateTaxCached() and evaluateTaxSenCached() through 'cache' (nullptr turns caching off).
+// The cache must outlive every calculation that may use it.
+inline void installTaxCache(TaxCache* cache) {
+    taxcache::installed().store(cache, std::memory_order_release);
+}
+
+inline TaxCache* installedTaxCache() {
+    return taxcache::installed().load(std::memory_order_acquire);
+}
+
+// evaluateTaxSen through the installed cache, if any
+inline Sen evaluateTaxSenCached(AssessmentType type, Sen taxableIncome) {
+    TaxCache* cache = installedTaxCache();
+    if (cache == nullptr) {
+        return evaluateTaxSen(type, taxableIncome);
+    }
+    TaxCacheKey key = {ACTIVE_SCHEDULE_ID, static_cast<std::uint8_t>(type),
+                       static_cast<std::uint8_t>(ArithmeticMode::FIXED_POINT), taxableIncome};
+    double tax;
+    if (cache->find(key, tax)) {
+        return static_cast<Sen>(tax);
+    }
+    Sen computed = evaluateTaxSen(type, taxableIncome);
+    cache->insert(key, static_cast<double>(computed));
+    return computed;
+}
+
+// evaluateTax through the installed cache, if any. Only finite incomes
+// inside the sen range that are a whole number of sen have a key.
+inline double evaluateTaxCached(AssessmentType type, double taxableIncome) {
+    TaxCache* cache = installedTaxCache();
+    if (cache == nullptr || !(taxableIncome > -toRinggit(SEN_LIMIT) && taxableIncome < toRinggit(SEN_LIMIT))) {
+        return evaluateTax(type, taxableIncome);
+    }
+    Sen sen = toSen(taxableIncome);
+    if (toRinggit(sen) != taxableIncome) {
+        return evaluateTax(type, taxableIncome);
+    }
+    TaxCacheKey key = {ACTIVE_SCHEDULE_ID, static_cast<std::uint8_t>(type),
+                       static_cast<std::uint8_t>(ArithmeticMode::FLOATING_POINT), sen};
+    double tax;
+    if (cache->find(key, tax)) {
+        return tax;
+    }
+    tax = evaluateTax(type, taxableIncome);
+    cache->insert(key, tax);
+    return tax;
+}
+
+#endif
@@ -0,0 +1,667 @@
+#ifndef TAX_CALCULATOR_HPP
+#define TAX_CALCULATOR_HPP
+
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "category_table.hpp"
+#include "date_context.hpp"
+#include "fixed_point.hpp"
+#include "instrumentation.hpp"
+#include "relief_optimizer.hpp"
+#include "report_buffer.hpp"
+#include "tax_cache.hpp"
+#include "tax_kernel.hpp"
+#include "tax_schedule.hpp"
+
+// Per-taxpayer calculator, its structure-of-arrays batch counterpart and
+// the household comparison, shared by the command-line program (main.cpp)
+// and the benchmarks (benchmark.cpp).
+
+struct Expense {
+    ExpenseCategory category;
+    std::string description;
+    double amount;
+};
+
+// An expense whose description lives elsewhere, such as in a mapped input file
+struct ExpenseRef {
+    ExpenseCategory category;
+    std::string_view description;
+    double amount;
+};
+
+// Income and deduction totals are kept up to date as entries are added,
+// updated or removed, and the computed tax is cached until the next change,
+// so repeated queries and reports cost O(1). Adding an entry extends the
+// totals; updating or removing one re-sums them from the entries, so they
+// always equal a fresh sum (subtracting an amount back out of a double or
+// saturated total would not).
+// Totals are tracked both in double and in sen; in FIXED_POINT mode every
+// result comes from the integer path and is exact to the sen.
+// All text (name, IC number, entry labels) shares one character pool, and
+// everything is allocated from 'resource', so a calculator built on an
+// arena (std::pmr::monotonic_buffer_resource) never touches the heap.
+class TaxCalculator {
+public:
+    TaxCalculator(std::string_view name, std::string_view icNo, AssessmentType type,
+                  ArithmeticMode mode = ArithmeticMode::FLOATING_POINT,
+                  std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : text(resource), incomeSources(resource), expenses(resource), assessmentType(type), arithmeticMode(mode),
+          totalIncome(0), totalDeductions(0), totalIncomeSen(0), totalDeductionsSen(0), cachedTax(0), taxDirty(true) {
+        this->name = store(name);
+        this->icNo = store(icNo);
+    }
+
+    // Makes room for this many more income sources and expenses, whose labels
+    // (income types and descriptions) add up to 'labelLength' characters
+    void reserve(std::size_t incomeCount, std::size_t expenseCount, std::size_t labelLength) {
+        incomeSources.reserve(incomeSources.size() + incomeCount);
+        expenses.reserve(expenses.size() + expenseCount);
+        text.reserve(text.size() + labelLength);
+    }
+
+    void addIncomeSource(std::string_view type, double amount) {
+        incomeSources.push_back({store(type), amount});
+        totalIncome += amount;
+        totalIncomeSen = addSen(totalIncomeSen, toSen(amount));
+        taxDirty = true;
+    }
+
+    bool updateIncomeSource(std::size_t index, double amount) {
+        if (index >= incomeSources.size()) {
+            return false;
+        }
+        incomeSources[index].amount = amount;
+        sumIncome();
+        return true;
+    }
+
+    bool removeIncomeSource(std::size_t index) {
+        if (index >= incomeSources.size()) {
+            return false;
+        }
+        incomeSources.erase(incomeSources.begin() + static_cast<std::ptrdiff_t>(index));
+        sumIncome();
+        return true;
+    }
+
+    void addExpense(std::string_view category, std::string_view description, double amount) {
+        ExpenseCategory id = findExpenseCategory(category);
+        if (id != ExpenseCategory::UNKNOWN) {
+            addExpense(id, description, amount);
+        } else {
+            std::cerr << "Category '" << category << "' is not allowed as per tax laws.\n";
+        }
+    }
+
+    void addExpense(ExpenseCategory category, std::string_view description, double amount) {
+        expenses.push_back({category, store(description), amount});
+        totalDeductions += amount;
+        totalDeductionsSen = addSen(totalDeductionsSen, toSen(amount));
+        taxDirty = true;
+    }
+
+    bool updateExpense(std::size_t index, double amount) {
+        if (index >= expenses.size()) {
+            return false;
+        }
+        expenses[index].amount = amount;
+        sumDeductions();
+        return true;
+    }
+
+    bool removeExpense(std::size_t index) {
+        if (index >= expenses.size()) {
+            return false;
+        }
+        expenses.erase(expenses.begin() + static_cast<std::ptrdiff_t>(index));
+        sumDeductions();
+        return true;
+    }
+
+    double calculateTotalIncome() const {
+        return arithmeticMode == ArithmeticMode::FIXED_POINT ? toRinggit(totalIncomeSen) : totalIncome;
+    }
+
+    double calculateTotalDeductions() const {
+        return arithmeticMode == ArithmeticMode::FIXED_POINT ? toRinggit(totalDeductionsSen) : totalDeductions;
+    }
+
+    double calculateTaxableIncome() const {
+        if (arithmeticMode == ArithmeticMode::FIXED_POINT) {
+            return toRinggit(calculateTaxableIncomeSen());
+        }
+        return totalIncome - totalDeductions;
+    }
+
+    double calculateTax() const {
+        if (taxDirty) {
+            TAX_STAGE_TIMER(Stage::BRACKET_EVALUATION);
+            // All assessment types share the same table-driven bracket kernel
+            if (arithmeticMode == ArithmeticMode::FIXED_POINT) {
+                cachedTax = toRinggit(evaluateTaxSenCached(assessmentType, calculateTaxableIncomeSen()));
+            } else {
+                cachedTax = evaluateTaxCached(assessmentType, calculateTaxableIncome());
+            }
+            taxDirty = false;
+        }
+        return cachedTax;
+    }
+
+    Sen calculateTaxableIncomeSen() const {
+        return totalIncomeSen - totalDeductionsSen;
+    }
+
+    // Exact tax in sen, whatever the arithmetic mode
+    Sen calculateTaxSen() const {
+        TAX_STAGE_TIMER(Stage::BRACKET_EVALUATION);
+        return evaluateTaxSenCached(assessmentType, calculateTaxableIncomeSen());
+    }
+
+    void generateTaxSummary(const std::string& filename, const DateContext& dates = DateContext::current()) {
+        ReportBuffer report;
+        if (!report.open(filename)) {
+            std::cerr << "Error opening file for writing." << std::endl;
+            return;
+        }
+        writeTaxSummary(report, dates);
+        if (!report.close()) {
+            std::cerr << "Error writing " << filename << "." << std::endl;
+            return;
+        }
+        std::cout << "Tax summary written to " << filename << std::endl;
+    }
+
+    // Appends the summary to 'report', so many summaries can share one buffer and file
+    void writeTaxSummary(ReportBuffer& report, const DateContext& dates = DateContext::current()) const {
+        TAX_STAGE_TIMER(Stage::REPORT_WRITING);
+        const std::string_view RULE = "--------------------------------------------------------\n";
+
+        report.append("===================== TAX SUMMARY =====================\n");
+        report.appendPadded("Name", 20).append(": ").append(view(name)).append('\n');
+        report.appendPadded("IC No.", 20).append(": ").append(view(icNo)).append('\n');
+        report.appendPadded("Assessment Type", 20).append(": ").append(assessmentTypeName(assessmentType)).append('\n');
+        report.appendPadded("Current Date", 20).append(": ").append(dates.currentDateText()).append('\n');
+        report.appendPadded("Tax Deadline", 20).append(": ").append(dates.deadlineText(assessmentType)).append('\n');
+        report.appendPadded("Days Remaining", 20).append(": ").appendInteger(dates.daysRemaining(assessmentType)).append('\n');
+        report.append(RULE);
+        report.appendPadded("Income Source", 30).appendPadded("Amount (RM)", 15).append('\n');
+        report.append(RULE);
+
+        for (const auto& income : incomeSources) {
+            report.appendPadded(view(income.type), 30).appendAmount(income.amount, 15).append('\n');
+        }
+
+        report.append(RULE);
+        report.appendPadded("Total Income", 30).appendAmount(calculateTotalIncome(), 15).append('\n');
+        report.append(RULE);
+        report.appendPadded("Expense Category", 30).appendPadded("Description", 20).appendPadded("Amount (RM)", 15).append('\n');
+        report.append(RULE);
+
+        for (const auto& expense : expenses) {
+            report.appendPadded(expenseCategoryName(expense.category), 30)
+                  .appendPadded(view(expense.description), 20)
+                  .appendAmount(expense.amount, 15).append('\n');
+        }
+
+        report.append(RULE);
+        report.appendPadded("Total Deductions", 30).appendAmount(calculateTotalDeductions(), 15).append('\n');
+        report.appendPadded("Taxable Income", 30).appendAmount(calculateTaxableIncome(), 15).append('\n');
+        report.appendPadded("Income Tax", 30).appendAmount(calculateTax(), 15).append('\n');
+        report.append("========================================================\n");
+    }
+
+private:
+    // A run of characters in 'text'
+    struct TextRef {
+        std::size_t offset;
+        std::size_t length;
+    };
+
+    struct IncomeEntry {
+        TextRef type;
+        double amount;
+    };
+
+    struct ExpenseEntry {
+        ExpenseCategory category;
+        TextRef description;
+        double amount;
+    };
+
+    std::pmr::string text;
+    std::pmr::vector<IncomeEntry> incomeSources;
+    std::pmr::vector<ExpenseEntry> expenses;
+    TextRef name;
+    TextRef icNo;
+    AssessmentType assessmentType;
+    ArithmeticMode arithmeticMode;
+    double totalIncome;
+    double totalDeductions;
+    Sen totalIncomeSen;
+    Sen totalDeductionsSen;
+    mutable double cachedTax;
+    mutable bool taxDirty;
+
+    // Totals in entry order, as the add calls (and TaxpayerBatch) accumulate them
+    void sumIncome() {
+        totalIncome = 0;
+        totalIncomeSen = 0;
+        for (const IncomeEntry& entry : incomeSources) {
+            totalIncome += entry.amount;
+            totalIncomeSen = addSen(totalIncomeSen, toSen(entry.amount));
+        }
+        taxDirty = true;
+    }
+
+    void sumDeductions() {
+        totalDeductions = 0;
+        totalDeductionsSen = 0;
+        for (const ExpenseEntry& entry : expenses) {
+            totalDeductions += entry.amount;
+            totalDeductionsSen = addSen(totalDeductionsSen, toSen(entry.amount));
+        }
+        taxDirty = true;
+    }
+
+    TextRef store(std::string_view value) {
+        TextRef ref = {text.size(), value.size()};
+        text.append(value);
+        return ref;
+    }
+
+    std::string_view view(TextRef ref) const {
+        return std::string_view(text).substr(ref.offset, ref.length);
+    }
+};
+
+// Structure-of-arrays counterpart of TaxCalculator for many taxpayers.
+// Income and deduction amounts of all taxpayers sit in two flat arrays,
+// indexed through offset arrays; names and IC numbers share one character
+// pool. clear() keeps the capacity, so a reused batch stops allocating once
+// it has seen its largest block. Calculations match TaxCalculator exactly,
+// in either arithmetic mode; the bracket pass runs on the array kernels
+// (tax_kernel.hpp, calculateTaxesSen), one assessment type at a time.
+class TaxpayerBatch {
+public:
+    explicit TaxpayerBatch(ArithmeticMode mode = ArithmeticMode::FLOATING_POINT) : arithmeticMode(mode) {
+        incomeOffsets.push_back(0);
+        deductionOffsets.push_back(0);
+        labelOffsets.push_back(0);
+    }
+
+    // Starts a new taxpayer; following add calls apply to it.
+    // 'filingDay' is the civil day number the return was filed on.
+    void addTaxpayer(std::string_view name, std::string_view icNo, AssessmentType type, long filingDay) {
+        types.push_back(type);
+        filingDays.push_back(filingDay);
+        labels.append(name);
+        labelOffsets.push_back(labels.size());
+        labels.append(icNo);
+        labelOffsets.push_back(labels.size());
+        incomeOffsets.push_back(incomeAmounts.size());
+        deductionOffsets.push_back(deductionAmounts.size());
+    }
+
+    void addIncomeSource(double amount) {
+        incomeAmounts.push_back(amount);
+        ++incomeOffsets.back();
+    }
+
+    // Returns false, and adds nothing, if 'category' is not allowed as per tax laws
+    bool addExpense(std::string_view category, double amount) {
+        if (!isCategoryAllowed(category)) {
+            return false;
+        }
+        deductionAmounts.push_back(amount);
+        ++deductionOffsets.back();
+        return true;
+    }
+
+    // Drops the last taxpayer added (e.g. when the rest of its record is malformed)
+    void discardLast() {
+        types.pop_back();
+        filingDays.pop_back();
+        incomeOffsets.pop_back();
+        deductionOffsets.pop_back();
+        labelOffsets.pop_back();
+        labelOffsets.pop_back();
+        incomeAmounts.resize(incomeOffsets.back());
+        deductionAmounts.resize(deductionOffsets.back());
+        labels.resize(labelOffsets.back());
+    }
+
+    void clear() {
+        types.clear();
+        filingDays.clear();
+        incomeAmounts.clear();
+        deductionAmounts.clear();
+        labels.clear();
+        incomeOffsets.resize(1);
+        deductionOffsets.resize(1);
+        labelOffsets.resize(1);
+    }
+
+    std::size_t size() const {
+        return types.size();
+    }
+
+    std::string_view name(std::size_t i) const {
+        return label(2 * i);
+    }
+
+    std::string_view icNo(std::size_t i) const {
+        return label(2 * i + 1);
+    }
+
+    AssessmentType assessmentType(std::size_t i) const {
+        return types[i];
+    }
+
+    long filingDay(std::size_t i) const {
+        return filingDays[i];
+    }
+
+    // Per-taxpayer results, one column per quantity
+    struct Results {
+        std::vector<double> totalIncome;
+        std::vector<double> totalDeductions;
+        std::vector<double> taxableIncome;
+        std::vector<double> tax;
+        std::vector<long> daysLate;
+
+        // Scratch for the bracket pass, kept so a reused Results stops allocating
+        std::vector<std::size_t> rows;
+        std::vector<double> gathered, gatheredTax;
+        std::vector<Sen> taxableSen, taxesSen, gatheredSen, gatheredTaxSen;
+    };
+
+    // One linear pass over each amount array, then the array kernel per assessment type
+    void calculateTaxes(Results& results) const {
+        std::size_t n = size();
+        results.totalIncome.resize(n);
+        results.totalDeductions.resize(n);
+        results.taxableIncome.resize(n);
+        results.tax.resize(n);
+        if (arithmeticMode == ArithmeticMode::FIXED_POINT) {
+            calculateTaxesSen(results);
+            return;
+        }
+
+        const double* income = incomeAmounts.data();
+        const double* deduction = deductionAmounts.data();
+        {
+            TAX_STAGE_TIMER(Stage::INCOME_AGGREGATION);
+            for (std::size_t i = 0; i < n; i++) {
+                double totalIncome = 0;
+                for (std::size_t k = incomeOffsets[i]; k < incomeOffsets[i + 1]; k++) {
+                    totalIncome += income[k];
+                }
+                results.totalIncome[i] = totalIncome;
+            }
+        }
+        {
+            TAX_STAGE_TIMER(Stage::DEDUCTION_AGGREGATION);
+            for (std::size_t i = 0; i < n; i++) {
+                double totalDeductions = 0;
+                for (std::size_t k = deductionOffsets[i]; k < deductionOffsets[i + 1]; k++) {
+                    totalDeductions += deduction[k];
+                }
+                results.totalDeductions[i] = totalDeductions;
+                results.taxableIncome[i] = results.totalIncome[i] - totalDeductions;
+            }
+        }
+
+        TAX_STAGE_TIMER(Stage::BRACKET_EVALUATION);
+        evaluateByType(results.taxableIncome, results.tax, results.rows, results.gathered, results.gatheredTax,
+                       [](AssessmentType type, const double* taxable, double* taxes, std::size_t count) {
+                           ::calculateTaxes(type, taxable, taxes, count);
+                       });
+    }
+
+    // Days each return was filed past its deadline in 'dates', one pass over the filing days
+    void calculateDaysLate(const DateContext& dates, Results& results) const {
+        TAX_STAGE_TIMER(Stage::DATE_HANDLING);
+        results.daysLate.resize(size());
+        for (std::size_t i = 0; i < size(); i++) {
+            results.daysLate[i] = dates.daysLate(types[i], filingDays[i]);
+        }
+    }
+
+private:
+    ArithmeticMode arithmeticMode;
+    std::vector<AssessmentType> types;
+    std::vector<long> filingDays;
+    std::vector<std::size_t> incomeOffsets;    // size() + 1 entries
+    std::vector<double> incomeAmounts;
+    std::vector<std::size_t> deductionOffsets; // size() + 1 entries
+    std::vector<double> deductionAmounts;
+    std::vector<std::size_t> labelOffsets;     // 2 * size() + 1 entries
+    std::string labels;
+
+    std::string_view label(std::size_t k) const {
+        return std::string_view(labels).substr(labelOffsets[k], labelOffsets[k + 1] - labelOffsets[k]);
+    }
+
+    // Same pass with every amount rounded to the sen, as TaxCalculator does in FIXED_POINT mode
+    void calculateTaxesSen(Results& results) const {
+        results.taxableSen.resize(size());
+        {
+            TAX_STAGE_TIMER(Stage::INCOME_AGGREGATION);
+            for (std::size_t i = 0; i < size(); i++) {
+                Sen totalIncome = 0;
+                for (std::size_t k = incomeOffsets[i]; k < incomeOffsets[i + 1]; k++) {
+                    totalIncome = addSen(totalIncome, toSen(incomeAmounts[k]));
+                }
+                results.totalIncome[i] = toRinggit(totalIncome);
+                results.taxableSen[i] = totalIncome;
+            }
+        }
+        {
+            TAX_STAGE_TIMER(Stage::DEDUCTION_AGGREGATION);
+            for (std::size_t i = 0; i < size(); i++) {
+                Sen totalDeductions = 0;
+                for (std::size_t k = deductionOffsets[i]; k < deductionOffsets[i + 1]; k++) {
+                    totalDeductions = addSen(totalDeductions, toSen(deductionAmounts[k]));
+                }
+                Sen taxableIncome = results.taxableSen[i] - totalDeductions;
+                results.totalDeductions[i] = toRinggit(totalDeductions);
+                results.taxableIncome[i] = toRinggit(taxableIncome);
+                results.taxableSen[i] = taxableIncome;
+            }
+        }
+
+        TAX_STAGE_TIMER(Stage::BRACKET_EVALUATION);
+        results.taxesSen.resize(size());
+        evaluateByType(results.taxableSen, results.taxesSen, results.rows, results.gatheredSen, results.gatheredTaxSen,
+                       [](AssessmentType type, const Sen* taxable, Sen* out, std::size_t count) {
+                           ::calculateTaxesSen(type, taxable, out, count);
+                       });
+        for (std::size_t i = 0; i < size(); i++) {
+            results.tax[i] = toRinggit(results.taxesSen[i]);
+        }
+    }
+
+    // taxes[i] = kernel(types[i], taxable[i]) for every taxpayer: the rows of each
+    // assessment type are gathered into one contiguous run for 'kernel' and scattered back.
+    template <class Value, class Kernel>
+    void evaluateByType(const std::vector<Value>& taxable, std::vector<Value>& taxes, std::vector<std::size_t>& rows,
+                        std::vector<Value>& gathered, std::vector<Value>& gatheredTax, Kernel kernel) const {
+        const AssessmentType ALL_TYPES[3] = {AssessmentType::INDIVIDUAL, AssessmentType::JOINT,
+                                             AssessmentType::SOLE_PROPRIETOR};
+        for (AssessmentType type : ALL_TYPES) {
+            rows.clear();
+            gathered.clear();
+            for (std::size_t i = 0; i < size(); i++) {
+                if (types[i] == type) {
+                    rows.push_back(i);
+                    gathered.push_back(taxable[i]);
+                }
+            }
+            gatheredTax.resize(gathered.size());
+            kernel(type, gathered.data(), gatheredTax.data(), gathered.size());
+            for (std::size_t j = 0; j < rows.size(); j++) {
+                taxes[rows[j]] = gatheredTax[j];
+            }
+        }
+    }
+};
+
+struct HouseholdComparison {
+    double individualTax1;
+    double individualTax2;
+    double totalIndividualTax;
+    double jointTax;
+    // Individual assessment with the transferable reliefs split optimally
+    double reliefToSpouse1;
+    double reliefToSpouse2;
+    double optimizedTax1;
+    double optimizedTax2;
+    double totalOptimizedTax;
+};
+
+// Tax on 'taxableIncome' less 'relief', in the requested arithmetic
+inline double taxAfterRelief(AssessmentType type, double taxableIncome, double relief, ArithmeticMode mode) {
+    TAX_STAGE_TIMER(Stage::BRACKET_EVALUATION);
+    if (mode == ArithmeticMode::FIXED_POINT) {
+        return toRinggit(evaluateTaxSenCached(type, toSen(taxableIncome) - toSen(relief)));
+    }
+    return evaluateTaxCached(type, taxableIncome - relief);
+}
+
+// Taxes for two spouses assessed individually and jointly, sharing the same expenses.
+// Transferable 'reliefs' go to the joint assessment in full; individually,
+// spouse 1 claims them first, and the optimized figures use the best split.
+// 'expenses' is a vector of Expense or ExpenseRef. The three calculators are
+// allocated from 'resource', each with one block per array.
+template <class ExpenseList>
+HouseholdComparison assessHousehold(std::string_view name1, std::string_view icNo1, double income1,
+                                    std::string_view name2, std::string_view icNo2, double income2,
+                                    const ExpenseList& expenses, const std::vector<ReliefClaim>& reliefs,
+                                    ArithmeticMode mode = ArithmeticMode::FLOATING_POINT,
+                                    std::pmr::memory_resource* resource = std::pmr::get_default_resource()) {
+    TAX_STAGE_TIMER(Stage::HOUSEHOLD_COMPARISON);
+    const std::string_view SALARY = "Salary";
+    std::size_t labelLength = SALARY.size();
+    for (const auto& expense : expenses) {
+        labelLength += expense.description.size();
+    }
+
+    // Create Individual Assessment for Person 1
+    TaxCalculator individual1(name1, icNo1, AssessmentType::INDIVIDUAL, mode, resource);
+    individual1.reserve(1, expenses.size(), labelLength);
+    for (const auto& expense : expenses) {
+        individual1.addExpense(expense.category, expense.description, expense.amount);
+    }
+    individual1.addIncomeSource(SALARY, income1);
+
+    // Create Individual Assessment for Person 2
+    TaxCalculator individual2(name2, icNo2, AssessmentType::INDIVIDUAL, mode, resource);
+    individual2.reserve(1, expenses.size(), labelLength);
+    for (const auto& expense : expenses) {
+        individual2.addExpense(expense.category, expense.description, expense.amount);
+    }
+    individual2.addIncomeSource(SALARY, income2);
+
+    // Create Joint Assessment
+    std::pmr::string jointName(name1, resource);
+    jointName.append(" & ").append(name2);
+    std::pmr::string jointIcNo(icNo1, resource);
+    jointIcNo.append(", ").append(icNo2);
+    TaxCalculator joint(jointName, jointIcNo, AssessmentType::JOINT, mode, resource);
+    joint.reserve(1, expenses.size(), labelLength);
+    for (const auto& expense : expenses) {
+        joint.addExpense(expense.category, expense.description, expense.amount);
+    }
+    joint.addIncomeSource(SALARY, income1 + income2);
+
+    // Calculate taxes
+    HouseholdComparison result;
+    if (reliefs.empty()) {
+        result.individualTax1 = individual1.calculateTax();
+        result.individualTax2 = individual2.calculateTax();
+        result.totalIndividualTax = result.individualTax1 + result.individualTax2;
+        result.jointTax = joint.calculateTax();
+        result.reliefToSpouse1 = 0;
+        result.reliefToSpouse2 = 0;
+        result.optimizedTax1 = result.individualTax1;
+        result.optimizedTax2 = result.individualTax2;
+        result.totalOptimizedTax = result.totalIndividualTax;
+        return result;
+    }
+
+    double taxable1 = individual1.calculateTaxableIncome();
+    double taxable2 = individual2.calculateTaxableIncome();
+    ReliefSplit naive = firstSpouseReliefSplit(INDIVIDUAL_SCHEDULE, taxable1, taxable2, reliefs.data(), reliefs.size());
+    ReliefSplit best = optimizeReliefSplit(INDIVIDUAL_SCHEDULE, taxable1, taxable2, reliefs.data(), reliefs.size());
+
+    result.individualTax1 = taxAfterRelief(AssessmentType::INDIVIDUAL, taxable1, naive.toSpouse1, mode);
+    result.individualTax2 = taxAfterRelief(AssessmentType::INDIVIDUAL, taxable2, naive.toSpouse2, mode);
+    result.totalIndividualTax = result.individualTax1 + result.individualTax2;
+    result.jointTax = taxAfterRelief(AssessmentType::JOINT, joint.calculateTaxableIncome(), best.claimed, mode);
+    result.reliefToSpouse1 = best.toSpouse1;
+    result.reliefToSpouse2 = best.toSpouse2;
+    result.optimizedTax1 = taxAfterRelief(AssessmentType::INDIVIDUAL, taxable1, best.toSpouse1, mode);
+    result.optimizedTax2 = taxAfterRelief(AssessmentType::INDIVIDUAL, taxable2, best.toSpouse2, mode);
+    result.totalOptimizedTax = result.optimizedTax1 + result.optimizedTax2;
+    return result;
+}
+
+inline void compareAssessments(const std::string& name1, const std::string& icNo1, double income1,
+                        const std::string& name2, const std::string& icNo2, double income2,
+                        const std::vector<Expense>& expenses, const std::vector<ReliefClaim>& reliefs,
+                        const std::string& filename) {
+    HouseholdComparison result = assessHousehold(name1, icNo1, income1, name2, icNo2, income2, expenses, reliefs);
+    double individualTax1 = result.individualTax1;
+    double individualTax2 = result.individualTax2;
+    double totalIndividualTax = result.totalIndividualTax;
+    double jointTax = result.jointTax;
+
+    // Write comparison to file
+    TAX_STAGE_TIMER(Stage::REPORT_WRITING);
+    std::ofstream outFile(filename);
+    if (!outFile) {
+        std::cerr << "Error opening file for writing." << std::endl;
+        return;
+    }
+
+    outFile << "===================== TAX COMPARISON =====================\n";
+    outFile << std::setw(30) << std::left << "Assessment Type" << std::setw(20) << "Tax (RM)" << "\n";
+    outFile << "--------------------------------------------------------\n";
+    outFile << std::setw(30) << "Individual Assessment (Person 1)" << std::setw(20) << individualTax1 << "\n";
+    outFile << std::setw(30) << "Individual Assessment (Person 2)" << std::setw(20) << individualTax2 << "\n";
+    outFile << std::setw(30) << "Total Individual Tax" << std::setw(20) << totalIndividualTax << "\n";
+    outFile << std::setw(30) << "Joint Assessment" << std::setw(20) << jointTax << "\n";
+    if (!reliefs.empty()) {
+        // The recommendation compares joint assessment with the best relief split
+        totalIndividualTax = result.totalOptimizedTax;
+        outFile << "--------------------------------------------------------\n";
+        outFile << std::setw(30) << "Relief Claimed by Person 1" << std::setw(20) << result.reliefToSpouse1 << "\n";
+        outFile << std::setw(30) << "Relief Claimed by Person 2" << std::setw(20) << result.reliefToSpouse2 << "\n";
+        outFile << std::setw(30) << "Best Split Tax (Person 1)" << std::setw(20) << result.optimizedTax1 << "\n";
+        outFile << std::setw(30) << "Best Split Tax (Person 2)" << std::setw(20) << result.optimizedTax2 << "\n";
+        outFile << std::setw(30) << "Best Split Total Tax" << std::setw(20) << result.totalOptimizedTax << "\n";
+    }
+    outFile << "--------------------------------------------------------\n";
+
+    if (jointTax < totalIndividualTax) {
+        outFile << "Joint Assessment provides lower tax.\n";
+    } else if (jointTax > totalIndividualTax) {
+        outFile << "Individual Assessment provides lower tax.\n";
+    } else {
+        outFile << "Both assessments result in the same tax.\n";
+    }
+
+    outFile << "========================================================\n";
+
+    outFile.close();
+    std::cout << "Tax comparison written to " << filename << std::endl;
+}
+
+#endif
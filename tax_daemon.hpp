@@ -0,0 +1,314 @@
+#ifndef TAX_DAEMON_HPP
+#define TAX_DAEMON_HPP
+
+// Single-threaded epoll server for line-delimited requests on a Unix
+// domain socket (Linux only). Every complete line a client sends is handed
+// to the handler, and whatever the handler appends to the reply buffer is
+// sent back, in request order, on the same connection. Clients may
+// pipeline any number of requests. SIGINT or SIGTERM stops the server
+// and removes the socket file.
+
+#ifdef __linux__
+#define TAX_DAEMON_SUPPORTED 1
+
+#include <cerrno>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "report_buffer.hpp"
+
+const std::size_t MAX_REQUEST_LENGTH = 65536;     // longest accepted request line
+const std::size_t MAX_PENDING_REPLY = 1 << 20;    // stop reading a client with this much unsent
+
+namespace taxdaemon {
+
+struct Connection {
+    explicit Connection(int fd) : fd(fd) {}
+
+    int fd;
+    std::string input;
+    std::string output;
+    std::size_t outputSent = 0;
+    std::uint32_t events = 0;  // epoll interest currently registered
+    bool endOfInput = false;   // the client has shut down its sending side
+    bool closing = false;      // no more requests; close once 'output' is flushed
+};
+
+struct ServerStats {
+    unsigned long long connections = 0;
+    unsigned long long requests = 0;
+};
+
+inline void setInterest(int epollFd, Connection& connection, std::uint32_t events) {
+    if (connection.events == events) {
+        return;
+    }
+    epoll_event event = {};
+    event.events = events;
+    event.data.fd = connection.fd;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+    connection.events = events;
+}
+
+// Sends as much pending output as the socket takes; false on a broken connection
+inline bool flushOutput(Connection& connection) {
+    while (connection.outputSent < connection.output.size()) {
+        ssize_t sent = send(connection.fd, connection.output.data() + connection.outputSent,
+                            connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        connection.outputSent += static_cast<std::size_t>(sent);
+    }
+    connection.output.clear();
+    connection.outputSent = 0;
+    return true;
+}
+
+// Answers every complete buffered line, unless the client is not reading its replies
+template <class Handler>
+void answerRequests(Connection& connection, Handler& handle, ReportBuffer& reply, ServerStats& stats) {
+    std::size_t consumed = 0;
+    bool partialLine = false;
+    while (connection.output.size() < MAX_PENDING_REPLY) {
+        std::size_t end = connection.input.find('\n', consumed);
+        if (end == std::string::npos) {
+            partialLine = true;
+            break;
+        }
+        std::string_view line(connection.input.data() + consumed, end - consumed);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        reply.clear();
+        handle(line, reply);
+        connection.output.append(reply.view());
+        consumed = end + 1;
+        ++stats.requests;
+    }
+    connection.input.erase(0, consumed);
+    if (partialLine && connection.input.size() > MAX_REQUEST_LENGTH) {
+        connection.output.append("ERR request too long\n");
+        connection.input.clear();
+        connection.closing = true;
+    }
+}
+
+} // namespace taxdaemon
+
+// Serves 'socketPath' until SIGINT or SIGTERM. 'handle' is called as
+// handle(std::string_view request, ReportBuffer& reply) and must append one
+// newline-terminated reply. Returns 0 after a clean shutdown, -1 on setup errors.
+template <class Handler>
+int serveUnixSocket(const std::string& socketPath, Handler& handle) {
+    using taxdaemon::Connection;
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Socket path too long: " << socketPath << std::endl;
+        return -1;
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    // Replace a stale socket left by an earlier run, but never any other file
+    struct stat existing;
+    if (stat(socketPath.c_str(), &existing) == 0 && S_ISSOCK(existing.st_mode)) {
+        unlink(socketPath.c_str());
+    }
+
+    int listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd < 0 || bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(listenFd, SOMAXCONN) != 0) {
+        std::cerr << "Cannot listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        if (listenFd >= 0) {
+            close(listenFd);
+        }
+        return -1;
+    }
+
+    // Shutdown signals arrive as readable events instead of interrupting the loop
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    sigset_t previousSignals;
+    sigprocmask(SIG_BLOCK, &signals, &previousSignals);
+    int signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    epoll_event event = {};
+    event.events = EPOLLIN;
+    event.data.fd = listenFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, listenFd, &event);
+    event.data.fd = signalFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, signalFd, &event);
+
+    // Held in reserve so that a client can still be accepted, and turned away,
+    // when the process runs out of descriptors; otherwise the pending
+    // connection would keep the listening socket readable forever
+    int spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+
+    std::vector<std::unique_ptr<Connection>> connections; // indexed by file descriptor
+    taxdaemon::ServerStats stats;
+    ReportBuffer reply;
+    std::vector<epoll_event> ready(256);
+    char buffer[65536];
+    bool running = signalFd >= 0 && epollFd >= 0;
+    bool failed = !running;
+    if (running) {
+        std::cout << "Serving tax queries on " << socketPath << " (Ctrl+C to stop)" << std::endl;
+    }
+
+    auto closeConnection = [&](int fd) {
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+        close(fd);
+        connections[static_cast<std::size_t>(fd)].reset();
+    };
+
+    while (running) {
+        int count = epoll_wait(epollFd, ready.data(), static_cast<int>(ready.size()), -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            failed = true;
+            break;
+        }
+        for (int e = 0; e < count; e++) {
+            int fd = ready[static_cast<std::size_t>(e)].data.fd;
+            std::uint32_t events = ready[static_cast<std::size_t>(e)].events;
+
+            if (fd == signalFd) {
+                // Consume the signal so it is not delivered once it is unblocked again
+                signalfd_siginfo received;
+                while (read(signalFd, &received, sizeof(received)) == static_cast<ssize_t>(sizeof(received))) {
+                }
+                running = false;
+                continue;
+            }
+            if (fd == listenFd) {
+                while (true) {
+                    int client = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (client < 0) {
+                        if (errno == EINTR || errno == ECONNABORTED) {
+                            continue;
+                        }
+                        if ((errno == EMFILE || errno == ENFILE) && spareFd >= 0) {
+                            // Out of descriptors: free the spare to drop the waiting client
+                            close(spareFd);
+                            int rejected = accept4(listenFd, nullptr, nullptr, SOCK_CLOEXEC);
+                            if (rejected >= 0) {
+                                close(rejected);
+                            }
+                            spareFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+                            if (rejected >= 0) {
+                                continue;
+                            }
+                        }
+                        break; // EAGAIN, or a failure the next readiness event retries
+                    }
+                    if (connections.size() <= static_cast<std::size_t>(client)) {
+                        connections.resize(static_cast<std::size_t>(client) + 1);
+                    }
+                    connections[static_cast<std::size_t>(client)].reset(new Connection(client));
+                    epoll_event clientEvent = {};
+                    clientEvent.events = EPOLLIN;
+                    clientEvent.data.fd = client;
+                    epoll_ctl(epollFd, EPOLL_CTL_ADD, client, &clientEvent);
+                    connections[static_cast<std::size_t>(client)]->events = EPOLLIN;
+                    ++stats.connections;
+                }
+                continue;
+            }
+
+            if (static_cast<std::size_t>(fd) >= connections.size() || !connections[static_cast<std::size_t>(fd)]) {
+                continue;
+            }
+            Connection& connection = *connections[static_cast<std::size_t>(fd)];
+            bool broken = false;
+            if (!connection.endOfInput && (events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                while (connection.input.size() <= MAX_PENDING_REPLY) {
+                    ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+                    if (received > 0) {
+                        connection.input.append(buffer, static_cast<std::size_t>(received));
+                    } else if (received == 0) {
+                        // A last request without a newline still gets its reply
+                        connection.endOfInput = true;
+                        if (!connection.input.empty() && connection.input.back() != '\n') {
+                            connection.input.push_back('\n');
+                        }
+                        break;
+                    } else if (errno != EINTR) {
+                        broken = errno != EAGAIN && errno != EWOULDBLOCK;
+                        break;
+                    }
+                }
+            }
+            // Answer and send until the socket is full or no complete request is left;
+            // requests held back by a full reply buffer must not wait for more input
+            bool flushed = !broken;
+            while (flushed) {
+                if (!connection.closing) {
+                    taxdaemon::answerRequests(connection, handle, reply, stats);
+                    connection.closing = connection.closing || (connection.endOfInput && connection.input.empty());
+                }
+                flushed = taxdaemon::flushOutput(connection);
+                if (connection.closing || !connection.output.empty() ||
+                    connection.input.find('\n') == std::string::npos) {
+                    break;
+                }
+            }
+            if (!flushed || (connection.closing && connection.output.empty())) {
+                closeConnection(fd);
+                continue;
+            }
+            // Stop reading a client that is not taking its replies
+            bool pending = !connection.output.empty();
+            bool reading = !connection.endOfInput && !connection.closing && connection.output.size() < MAX_PENDING_REPLY;
+            taxdaemon::setInterest(epollFd, connection,
+                                   (reading ? static_cast<std::uint32_t>(EPOLLIN) : 0u) |
+                                   (pending ? static_cast<std::uint32_t>(EPOLLOUT) : 0u));
+        }
+    }
+
+    for (std::size_t fd = 0; fd < connections.size(); fd++) {
+        if (connections[fd]) {
+            closeConnection(static_cast<int>(fd));
+        }
+    }
+    if (epollFd >= 0) {
+        close(epollFd);
+    }
+    if (signalFd >= 0) {
+        close(signalFd);
+    }
+    if (spareFd >= 0) {
+        close(spareFd);
+    }
+    close(listenFd);
+    unlink(socketPath.c_str());
+    sigprocmask(SIG_SETMASK, &previousSignals, nullptr);
+    std::cout << stats.connections << " connections, " << stats.requests << " requests served." << std::endl;
+    return failed ? -1 : 0;
+}
+
+#endif // __linux__
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef TAX_KERNEL_HPP
+#define TAX_KERNEL_HPP
+
+#include <cstddef>
+#include "tax_schedule.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TAX_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// Vectorized bracket evaluation over arrays of taxable incomes.
+// Every lane does the same work as TaxSchedule::evaluate: the bracket
+// base, threshold and rate are selected with compare + blend, then
+// tax = base + (income - threshold) * rate. Results are bit-identical to
+// the scalar path (no fused multiply-add is used).
+
+inline void calculateTaxesScalar(const TaxSchedule& schedule, const double* taxableIncomes,
+                                 double* taxes, std::size_t count) {
+    for (std::size_t i = 0; i < count; i++) {
+        taxes[i] = schedule.evaluate(taxableIncomes[i]);
+    }
+}
+
+#ifdef TAX_KERNEL_X86
+// SSE2: two incomes per step, blend done with and/andnot/or
+__attribute__((target("sse2")))
+inline void calculateTaxesSSE2(const TaxSchedule& schedule, const double* taxableIncomes,
+                               double* taxes, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d income = _mm_loadu_pd(taxableIncomes + i);
+        __m128d base = _mm_set1_pd(schedule.bases[0]);
+        __m128d threshold = _mm_set1_pd(schedule.thresholds[0]);
+        __m128d rate = _mm_set1_pd(schedule.rates[0]);
+        for (int k = 1; k < TaxSchedule::MAX_BRACKETS; k++) {
+            __m128d above = _mm_cmpgt_pd(income, _mm_set1_pd(schedule.thresholds[k]));
+            base = _mm_or_pd(_mm_and_pd(above, _mm_set1_pd(schedule.bases[k])), _mm_andnot_pd(above, base));
+            threshold = _mm_or_pd(_mm_and_pd(above, _mm_set1_pd(schedule.thresholds[k])), _mm_andnot_pd(above, threshold));
+            rate = _mm_or_pd(_mm_and_pd(above, _mm_set1_pd(schedule.rates[k])), _mm_andnot_pd(above, rate));
+        }
+        __m128d tax = _mm_add_pd(base, _mm_mul_pd(_mm_sub_pd(income, threshold), rate));
+        _mm_storeu_pd(taxes + i, tax);
+    }
+    calculateTaxesScalar(schedule, taxableIncomes + i, taxes + i, count - i);
+}
+
+// AVX2: four incomes per step
+__attribute__((target("avx2")))
+inline void calculateTaxesAVX2(const TaxSchedule& schedule, const double* taxableIncomes,
+                               double* taxes, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d income = _mm256_loadu_pd(taxableIncomes + i);
+        __m256d base = _mm256_set1_pd(schedule.bases[0]);
+        __m256d threshold = _mm256_set1_pd(schedule.thresholds[0]);
+        __m256d rate = _mm256_set1_pd(schedule.rates[0]);
+        for (int k = 1; k < TaxSchedule::MAX_BRACKETS; k++) {
+            __m256d above = _mm256_cmp_pd(income, _mm256_set1_pd(schedule.thresholds[k]), _CMP_GT_OQ);
+            base = _mm256_blendv_pd(base, _mm256_set1_pd(schedule.bases[k]), above);
+            threshold = _mm256_blendv_pd(threshold, _mm256_set1_pd(schedule.thresholds[k]), above);
+            rate = _mm256_blendv_pd(rate, _mm256_set1_pd(schedule.rates[k]), above);
+        }
+        __m256d tax = _mm256_add_pd(base, _mm256_mul_pd(_mm256_sub_pd(income, threshold), rate));
+        _mm256_storeu_pd(taxes + i, tax);
+    }
+    calculateTaxesScalar(schedule, taxableIncomes + i, taxes + i, count - i);
+}
+#endif
+
+// Writes taxes[i] = tax on taxableIncomes[i] under 'schedule' for i in [0, count).
+// Picks the widest instruction set the CPU supports at run time.
+inline void calculateTaxes(const TaxSchedule& schedule, const double* taxableIncomes,
+                           double* taxes, std::size_t count) {
+#ifdef TAX_KERNEL_X86
+    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+    static const bool hasSSE2 = __builtin_cpu_supports("sse2");
+    if (hasAVX2) {
+        calculateTaxesAVX2(schedule, taxableIncomes, taxes, count);
+        return;
+    }
+    if (hasSSE2) {
+        calculateTaxesSSE2(schedule, taxableIncomes, taxes, count);
+        return;
+    }
+#endif
+    calculateTaxesScalar(schedule, taxableIncomes, taxes, count);
+}
+
+inline void calculateTaxes(AssessmentType type, const double* taxableIncomes,
+                           double* taxes, std::size_t count) {
+    calculateTaxes(scheduleFor(type), taxableIncomes, taxes, count);
+}
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef TAX_SCHEDULE_HPP
+#define TAX_SCHEDULE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+enum class AssessmentType { INDIVIDUAL, JOINT, SOLE_PROPRIETOR };
+
+inline const char* assessmentTypeName(AssessmentType type) {
+    switch (type) {
+        case AssessmentType::INDIVIDUAL:
+            return "Individual";
+        case AssessmentType::JOINT:
+            return "Joint";
+        case AssessmentType::SOLE_PROPRIETOR:
+            return "Sole Proprietor";
+    }
+    return "";
+}
+
+// Piecewise-linear tax schedule stored as a flat table.
+// Bracket k covers taxable income above thresholds[k]; its tax is
+//   bases[k] + (taxableIncome - thresholds[k]) * rates[k]
+// where bases[k] is the tax already due at thresholds[k].
+// Unused brackets are padded with an infinite threshold so every lookup
+// runs the same fixed number of comparisons.
+struct TaxSchedule {
+    static const int MAX_BRACKETS = 8;
+
+    int count;
+    double thresholds[MAX_BRACKETS];
+    double bases[MAX_BRACKETS];
+    double rates[MAX_BRACKETS];
+
+    // Index of the bracket 'taxableIncome' falls into (no data-dependent branches)
+    int bracketIndex(double taxableIncome) const {
+        int index = 0;
+        for (int i = 1; i < MAX_BRACKETS; i++) {
+            index += taxableIncome > thresholds[i];
+        }
+        return index;
+    }
+
+    double evaluate(double taxableIncome) const {
+        int k = bracketIndex(taxableIncome);
+        return bases[k] + (taxableIncome - thresholds[k]) * rates[k];
+    }
+};
+
+// Compile-time bracket schedule with N brackets, laid out like TaxSchedule.
+// evaluate() has a fixed trip count, so calls on a constexpr schedule are
+// fully unrolled and inlined. The checks below are used in static_asserts
+// so a mistyped schedule fails to compile.
+template <std::size_t N>
+struct BracketSchedule {
+    double thresholds[N];
+    double bases[N];
+    double rates[N];
+
+    constexpr double evaluate(double taxableIncome) const {
+        std::size_t k = 0;
+        for (std::size_t i = 1; i < N; i++) {
+            k += taxableIncome > thresholds[i];
+        }
+        return bases[k] + (taxableIncome - thresholds[k]) * rates[k];
+    }
+
+    constexpr bool thresholdsIncrease() const {
+        for (std::size_t i = 1; i < N; i++) {
+            if (!(thresholds[i] > thresholds[i - 1])) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Each base must equal the tax due at its threshold under the previous bracket (to the sen)
+    constexpr bool basesAreCumulative() const {
+        for (std::size_t i = 1; i < N; i++) {
+            double expected = bases[i - 1] + (thresholds[i] - thresholds[i - 1]) * rates[i - 1];
+            double difference = expected - bases[i];
+            if (difference > 0.005 || difference < -0.005) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // FNV-1a over the bracket count and every threshold and base (in sen)
+    // and rate (in millionths), continuing from 'hash'
+    constexpr std::uint64_t fingerprint(std::uint64_t hash = 14695981039346656037ull) const {
+        hash = (hash ^ N) * 1099511628211ull;
+        for (std::size_t i = 0; i < N; i++) {
+            const double values[3] = {thresholds[i] * 100, bases[i] * 100, rates[i] * 1000000};
+            for (double value : values) {
+                auto word = static_cast<std::uint64_t>(static_cast<std::int64_t>(value < 0 ? value - 0.5 : value + 0.5));
+                for (int byte = 0; byte < 8; byte++) {
+                    hash = (hash ^ ((word >> (8 * byte)) & 0xff)) * 1099511628211ull;
+                }
+            }
+        }
+        return hash;
+    }
+};
+
+// Pads a compile-time schedule into the runtime table used by the array kernels
+template <std::size_t N>
+constexpr TaxSchedule toTaxSchedule(const BracketSchedule<N>& schedule) {
+    static_assert(N <= TaxSchedule::MAX_BRACKETS, "Too many brackets for TaxSchedule");
+    TaxSchedule table = {static_cast<int>(N), {}, {}, {}};
+    for (int i = 0; i < TaxSchedule::MAX_BRACKETS; i++) {
+        bool used = i < static_cast<int>(N);
+        table.thresholds[i] = used ? schedule.thresholds[i] : std::numeric_limits<double>::infinity();
+        table.bases[i] = used ? schedule.bases[i] : 0;
+        table.rates[i] = used ? schedule.rates[i] : 0;
+    }
+    return table;
+}
+
+namespace taxyear2023 {
+
+// Year of assessment the rates below apply to
+const int YEAR = 2023;
+
+// Malaysian individual tax rates for 2023 (example rates)
+constexpr BracketSchedule<8> INDIVIDUAL = {
+    {0, 5000, 20000, 35000, 50000, 70000, 100000, 250000},
+    {0, 0, 150, 600, 1500, 3700, 9400, 46900},
+    {0, 0.01, 0.03, 0.06, 0.11, 0.19, 0.25, 0.28}
+};
+
+// Malaysian joint tax rates for 2023 (example rates)
+constexpr BracketSchedule<7> JOINT = {
+    {0, 10000, 40000, 70000, 100000, 200000, 500000},
+    {0, 0, 600, 2100, 5100, 21100, 84100},
+    {0, 0.02, 0.05, 0.10, 0.16, 0.21, 0.24}
+};
+
+// Malaysian sole proprietor tax rates for 2023 (example rates)
+constexpr BracketSchedule<4> SOLE_PROPRIETOR = {
+    {0, 50000, 100000, 200000},
+    {0, 7500, 17500, 42500},
+    {0.15, 0.20, 0.25, 0.30}
+};
+
+static_assert(INDIVIDUAL.thresholdsIncrease() && INDIVIDUAL.basesAreCumulative(), "Bad 2023 individual schedule");
+static_assert(JOINT.thresholdsIncrease() && JOINT.basesAreCumulative(), "Bad 2023 joint schedule");
+static_assert(SOLE_PROPRIETOR.thresholdsIncrease() && SOLE_PROPRIETOR.basesAreCumulative(), "Bad 2023 sole proprietor schedule");
+
+} // namespace taxyear2023
+
+// Identifies the schedules below in persisted data (the tax cache file). It is
+// a hash of their contents, so editing any threshold, base or rate changes it
+// and entries computed under the old tables are no longer used.
+constexpr std::uint32_t scheduleId(std::uint64_t fingerprint) {
+    return static_cast<std::uint32_t>(fingerprint ^ (fingerprint >> 32));
+}
+
+// Year of assessment of the schedules below; returns for it are filed the year after
+const int ACTIVE_ASSESSMENT_YEAR = taxyear2023::YEAR;
+
+constexpr std::uint32_t ACTIVE_SCHEDULE_ID = scheduleId(
+    taxyear2023::SOLE_PROPRIETOR.fingerprint(taxyear2023::JOINT.fingerprint(taxyear2023::INDIVIDUAL.fingerprint())));
+
+static_assert(scheduleId(BracketSchedule<2>{{0, 5000}, {0, 0}, {0, 0.01}}.fingerprint()) !=
+              scheduleId(BracketSchedule<2>{{0, 5000}, {0, 0}, {0, 0.02}}.fingerprint()), "Schedule ID ignores rates");
+
+constexpr TaxSchedule INDIVIDUAL_SCHEDULE = toTaxSchedule(taxyear2023::INDIVIDUAL);
+constexpr TaxSchedule JOINT_SCHEDULE = toTaxSchedule(taxyear2023::JOINT);
+constexpr TaxSchedule SOLE_PROPRIETOR_SCHEDULE = toTaxSchedule(taxyear2023::SOLE_PROPRIETOR);
+
+inline const TaxSchedule& scheduleFor(AssessmentType type) {
+    switch (type) {
+        case AssessmentType::JOINT:
+            return JOINT_SCHEDULE;
+        case AssessmentType::SOLE_PROPRIETOR:
+            return SOLE_PROPRIETOR_SCHEDULE;
+        default:
+            return INDIVIDUAL_SCHEDULE;
+    }
+}
+
+// Tax for one taxpayer using the compile-time schedules (unrolled per type)
+constexpr double evaluateTax(AssessmentType type, double taxableIncome) {
+    switch (type) {
+        case AssessmentType::JOINT:
+            return taxyear2023::JOINT.evaluate(taxableIncome);
+        case AssessmentType::SOLE_PROPRIETOR:
+            return taxyear2023::SOLE_PROPRIETOR.evaluate(taxableIncome);
+        default:
+            return taxyear2023::INDIVIDUAL.evaluate(taxableIncome);
+    }
+}
+
+#endif
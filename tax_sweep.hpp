@@ -0,0 +1,84 @@
+#ifndef TAX_SWEEP_HPP
+#define TAX_SWEEP_HPP
+
+#include <cstddef>
+#include <vector>
+#include "tax_kernel.hpp"
+#include "tax_schedule.hpp"
+#include "thread_pool.hpp"
+
+// Tax, effective rate and marginal rate curves over an evenly spaced grid
+// of taxable incomes, straight from the bracket tables: each chunk of the
+// grid goes through the vectorized kernel once, so no TaxCalculator is built.
+
+// Incomes start, start + step, ... (points values, step > 0)
+struct IncomeGrid {
+    double start;
+    double step;
+    std::size_t points;
+
+    double income(std::size_t i) const {
+        return start + step * static_cast<double>(i);
+    }
+};
+
+// Largest grid makeIncomeGrid() builds: three curves of this many doubles
+// take 1.2 GB
+const std::size_t MAX_GRID_POINTS = 50000000;
+
+// Grid from 'start' to 'end' inclusive. 'points' is 0 when the range is
+// empty or not finite, or would need more than MAX_GRID_POINTS points.
+inline IncomeGrid makeIncomeGrid(double start, double end, double step) {
+    IncomeGrid grid = {start, step, 0};
+    double intervals = (end - start) / step + 1e-9;
+    if (step > 0 && intervals >= 0 && intervals < static_cast<double>(MAX_GRID_POINTS)) {
+        grid.points = static_cast<std::size_t>(intervals) + 1;
+    }
+    return grid;
+}
+
+// Curves for grid points [begin, end), written from index 0 of each array.
+// The effective rate is tax / income (0 at zero income); the marginal rate
+// is the rate of the bracket the income falls in.
+inline void sweepTaxCurves(const TaxSchedule& schedule, const IncomeGrid& grid, std::size_t begin, std::size_t end,
+                           double* tax, double* effectiveRate, double* marginalRate) {
+    std::size_t count = end - begin;
+    // effectiveRate holds the incomes until the kernel has run
+    double* incomes = effectiveRate;
+    for (std::size_t i = 0; i < count; i++) {
+        incomes[i] = grid.income(begin + i);
+    }
+    calculateTaxes(schedule, incomes, tax, count);
+
+    // Incomes increase along the grid, so the bracket only ever moves up
+    int k = count > 0 ? schedule.bracketIndex(incomes[0]) : 0;
+    for (std::size_t i = 0; i < count; i++) {
+        double income = incomes[i];
+        while (k + 1 < schedule.count && income > schedule.thresholds[k + 1]) {
+            ++k;
+        }
+        marginalRate[i] = schedule.rates[k];
+        effectiveRate[i] = income > 0 ? tax[i] / income : 0;
+    }
+}
+
+struct TaxCurves {
+    std::vector<double> tax;
+    std::vector<double> effectiveRate;
+    std::vector<double> marginalRate;
+};
+
+// Whole-grid curves for one assessment type, computed in chunks on 'pool'
+inline void sweepTaxCurves(WorkStealingPool& pool, AssessmentType type, const IncomeGrid& grid, TaxCurves& curves,
+                           std::size_t chunkSize = 65536) {
+    curves.tax.resize(grid.points);
+    curves.effectiveRate.resize(grid.points);
+    curves.marginalRate.resize(grid.points);
+    const TaxSchedule& schedule = scheduleFor(type);
+    pool.parallelFor(grid.points, chunkSize, [&](std::size_t begin, std::size_t end) {
+        sweepTaxCurves(schedule, grid, begin, end, curves.tax.data() + begin,
+                       curves.effectiveRate.data() + begin, curves.marginalRate.data() + begin);
+    });
+}
+
+#endif
@@ -33,84 +33,9 @@ double TaxCalculator::calculateTaxableIncome() {
     return totalIncome - calculateTotalDeductions();
 }
 
-double TaxCalculator::calculateIndividualTax(double taxableIncome) {
-    double tax = 0;
-
-    // Malaysian individual tax rates for 2023 (example rates)
-    if (taxableIncome <= 5000) {
-        tax = 0;
-    } else if (taxableIncome <= 20000) {
-        tax = (taxableIncome - 5000) * 0.01;
-    } else if (taxableIncome <= 35000) {
-        tax = 150 + (taxableIncome - 20000) * 0.03;
-    } else if (taxableIncome <= 50000) {
-        tax = 600 + (taxableIncome - 35000) * 0.06;
-    } else if (taxableIncome <= 70000) {
-        tax = 1800 + (taxableIncome - 50000) * 0.11;
-    } else if (taxableIncome <= 100000) {
-        tax = 4400 + (taxableIncome - 70000) * 0.19;
-    } else if (taxableIncome <= 250000) {
-        tax = 10300 + (taxableIncome - 100000) * 0.25;
-    } else {
-        tax = 50300 + (taxableIncome - 250000) * 0.28;
-    }
-
-    return tax;
-}
-
-double TaxCalculator::calculateJointTax(double taxableIncome) {
-    double tax = 0;
-
-    // Malaysian joint tax rates for 2023 (example rates)
-    if (taxableIncome <= 10000) {
-        tax = 0;
-    } else if (taxableIncome <= 40000) {
-        tax = (taxableIncome - 10000) * 0.02;
-    } else if (taxableIncome <= 70000) {
-        tax = 600 + (taxableIncome - 40000) * 0.05;
-    } else if (taxableIncome <= 100000) {
-        tax = 2100 + (taxableIncome - 70000) * 0.10;
-    } else if (taxableIncome <= 200000) {
-        tax = 5100 + (taxableIncome - 100000) * 0.16;
-    } else if (taxableIncome <= 500000) {
-        tax = 21100 + (taxableIncome - 200000) * 0.21;
-    } else {
-        tax = 84100 + (taxableIncome - 500000) * 0.24;
-    }
-
-    return tax;
-}
-
-double TaxCalculator::calculateSoleProprietorTax(double taxableIncome) {
-    double tax = 0;
-
-    // Malaysian sole proprietor tax rates for 2023 (example rates)
-    if (taxableIncome <= 50000) {
-        tax = taxableIncome * 0.15;
-    } else if (taxableIncome <= 100000) {
-        tax = 7500 + (taxableIncome - 50000) * 0.20;
-    } else if (taxableIncome <= 200000) {
-        tax = 17500 + (taxableIncome - 100000) * 0.25;
-    } else {
-        tax = 42500 + (taxableIncome - 200000) * 0.30;
-    }
-
-    return tax;
-}
-
 double TaxCalculator::calculateTax() {
-    double taxableIncome = calculateTaxableIncome();
-
-    switch (assessmentType) {
-        case AssessmentType::INDIVIDUAL:
-            return calculateIndividualTax(taxableIncome);
-        case AssessmentType::JOINT:
-            return calculateJointTax(taxableIncome);
-        case AssessmentType::SOLE_PROPRIETOR:
-            return calculateSoleProprietorTax(taxableIncome);
-        default:
-            return 0;
-    }
+    // All assessment types share the same table-driven bracket kernel
+    return evaluateTax(assessmentType, calculateTaxableIncome());
 }
 
 std::string TaxCalculator::getCurrentDate() {
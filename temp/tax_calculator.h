@@ -5,6 +5,7 @@
 #include <vector>
 #include <ctime>
 #include <map>
+#include "../tax_schedule.hpp"
 
 
 struct Expense {
@@ -13,7 +14,6 @@ struct Expense {
 };
 
 void compareAssessments(const std::string& name1, const std::string& icNo1, double income1, const std::string& name2, const std::string& icNo2, double income2, const std::vector<Expense>& expenses, const std::string& filename);
-enum class AssessmentType { INDIVIDUAL, JOINT, SOLE_PROPRIETOR };
 
 struct IncomeSource {
     std::string type;
@@ -40,9 +40,6 @@ private:
     std::string getCurrentDate();
     std::string getTaxDeadline();
     int getDaysRemaining();
-    double calculateIndividualTax(double taxableIncome);
-    double calculateJointTax(double taxableIncome);
-    double calculateSoleProprietorTax(double taxableIncome);
 };
 
 #endif
\ No newline at end of file
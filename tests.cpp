@@ -0,0 +1,623 @@
+// Regression checks for boundary cases in the calculation and report paths.
+//
+// Build from the repository root:
+//   g++ -O2 -pthread tests.cpp -o tests
+// Run:
+//   ./tests
+//
+// Prints every failed check and exits with status 1 if there was one.
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include "chunk_pipeline.hpp"
+#include "date_context.hpp"
+#include "record_reader.hpp"
+#include "relief_engine.hpp"
+#include "relief_optimizer.hpp"
+#include "report_buffer.hpp"
+#include "results_file.hpp"
+#include "tax_calculator.hpp"
+#include "tax_daemon.hpp"
+#include "tax_kernel.hpp"
+#include "tax_sweep.hpp"
+
+// ===================== HARNESS =====================
+static int checkCount = 0;
+static int failureCount = 0;
+
+void check(bool passed, const char* condition, const char* file, int line) {
+    ++checkCount;
+    if (!passed) {
+        ++failureCount;
+        std::cout << file << ":" << line << ": check failed: " << condition << "\n";
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __FILE__, __LINE__)
+
+// ===================== TESTS =====================
+void testReportBuffer() {
+    // Without a file the buffer just accumulates
+    ReportBuffer text;
+    text.appendPadded("Tax", 5).appendAmount(1234.5).append('\n');
+    CHECK(text.view() == "Tax  1234.50\n");
+    CHECK(text.close());
+
+#ifdef __linux__
+    // A write error during an automatic flush must still fail close()
+    ReportBuffer full(16);
+    CHECK(full.open("/dev/full"));
+    for (int i = 0; i < 100000; i++) {
+        full.append("0123456789abcdef");
+    }
+    CHECK(!full.flush());
+    CHECK(!full.close());
+
+    // ...and the error is forgotten once a new file is opened
+    CHECK(full.open("/dev/null"));
+    full.append("ok\n");
+    CHECK(full.close());
+#endif
+}
+
+void testCivilDates() {
+    CivilDate date;
+    CHECK(parseCivilDate("2024-02-29", date) && date.year == 2024 && date.month == 2 && date.day == 29);
+    CHECK(!parseCivilDate("2023-02-29", date));
+    CHECK(!parseCivilDate("1900-02-29", date));
+    CHECK(parseCivilDate("2000-02-29", date));
+    CHECK(!parseCivilDate("2023-04-31", date));
+    CHECK(parseCivilDate("2023-12-31", date));
+    CHECK(!parseCivilDate("2023-13-01", date));
+    CHECK(!parseCivilDate("2023-01-00", date));
+
+    // Deadlines follow the assessment year, not the date of the run
+    DateContext dates({2026, 10, 17}, 2023);
+    CHECK(dates.deadlineText(AssessmentType::INDIVIDUAL) == "2024-04-30");
+    CHECK(dates.deadlineText(AssessmentType::SOLE_PROPRIETOR) == "2024-06-30");
+    CHECK(dates.daysLate(AssessmentType::JOINT, daysFromCivil({2024, 5, 3})) == 3);
+    CHECK(dates.daysLate(AssessmentType::SOLE_PROPRIETOR, daysFromCivil({2024, 5, 3})) == 0);
+    CHECK(DateContext({2026, 1, 1}).deadline(AssessmentType::INDIVIDUAL).year == ACTIVE_ASSESSMENT_YEAR + 1);
+}
+
+void testReliefSplit() {
+    // Three children under 18 and two disabled children: per-child amounts are
+    // not capped at twice the single-child amount, and either spouse may take them
+    const ReliefClaim claims[] = {{15, 6000}, {17, 12000}, {1, 20000}};
+    double shares1[3];
+    ReliefSplit best = optimizeReliefSplit(INDIVIDUAL_SCHEDULE, 200000, 10000, claims, 3, shares1);
+    CHECK(best.claimed == 6000 + 12000 + 16000);
+    CHECK(best.toSpouse1 == shares1[0] + shares1[1] + shares1[2]);
+    CHECK(shares1[0] == 6000 && shares1[1] == 12000 && shares1[2] == 8000);
+
+    ReliefSplit naive = firstSpouseReliefSplit(INDIVIDUAL_SCHEDULE, 200000, 10000, claims, 3);
+    CHECK(naive.claimed == best.claimed && naive.toSpouse1 == 6000 + 12000 + 8000);
+    CHECK(best.totalTax <= naive.totalTax);
+
+    // Per-child reliefs are capped at RELIEF_MAX_CHILDREN children per spouse, as in relief_engine.hpp
+    const ReliefClaim huge[] = {{15, 1e9}};
+    ReliefSplit capped = optimizeReliefSplit(INDIVIDUAL_SCHEDULE, 1e9, 1e9, huge, 1);
+    CHECK(capped.claimed == 2.0 * RELIEF_MAX_CHILDREN * RELIEF_UNIT_AMOUNTS[15]);
+    CHECK(capped.toSpouse1 == RELIEF_MAX_CHILDREN * RELIEF_UNIT_AMOUNTS[15]);
+}
+
+void testIncomeGrid() {
+    CHECK(makeIncomeGrid(0, 1000, 0.5).points == 2001);
+    CHECK(makeIncomeGrid(5, 5, 1).points == 1);
+    CHECK(makeIncomeGrid(10, 5, 1).points == 0);
+    CHECK(makeIncomeGrid(0, 1000, 0).points == 0);
+    CHECK(makeIncomeGrid(0, 2000000, 1e-300).points == 0);
+    CHECK(makeIncomeGrid(0, 1e12, 1).points == 0);
+}
+
+void testReliefCapping() {
+    // Extreme answers in every column, for every profile: no cell or total may wrap
+    const std::int32_t extremes[] = {INT32_MAX, 400000, 1000000000, -1, INT32_MIN, 2};
+    const int ROWS = 6 * RELIEF_PROFILE_COUNT;
+    std::int32_t claims[ROWS * RELIEF_COLUMNS] = {};
+    ReliefProfile profiles[ROWS];
+    for (int r = 0; r < ROWS; r++) {
+        profiles[r] = static_cast<ReliefProfile>(r % RELIEF_PROFILE_COUNT);
+        for (int c = 0; c < RELIEF_CATEGORY_COUNT; c++) {
+            claims[r * RELIEF_COLUMNS + c] = extremes[r / RELIEF_PROFILE_COUNT];
+        }
+    }
+    std::int32_t expected[ROWS * RELIEF_COLUMNS], expectedTotals[ROWS];
+    capReliefsScalar(claims, profiles, expected, expectedTotals, ROWS);
+    for (int r = 0; r < ROWS; r++) {
+        CHECK(expectedTotals[r] >= 0 && expectedTotals[r] <= maxReliefRowTotal());
+    }
+    // Married with children, every answer INT32_MAX: each cap, plus 99 children per child relief
+    CHECK(expectedTotals[2] == 91350 + 99 * (2000 + 2000 + 6000));
+
+    std::int32_t capped[ROWS * RELIEF_COLUMNS], totals[ROWS];
+    capReliefs(claims, profiles, capped, totals, ROWS);
+    bool same = true;
+    for (int i = 0; i < ROWS * RELIEF_COLUMNS; i++) {
+        same = same && capped[i] == expected[i];
+    }
+    for (int r = 0; r < ROWS; r++) {
+        same = same && totals[r] == expectedTotals[r];
+    }
+    CHECK(same);
+#ifdef RELIEF_ENGINE_X86
+    if (__builtin_cpu_supports("sse4.1")) {
+        capReliefsSSE41(claims, profiles, capped, totals, ROWS);
+        CHECK(totals[2] == expectedTotals[2] && totals[ROWS - 1] == expectedTotals[ROWS - 1]);
+    }
+#endif
+}
+
+// Equal, or both NaN
+bool sameTax(double a, double b) {
+    return a == b || (a != a && b != b);
+}
+
+void testTaxKernels() {
+    const AssessmentType ALL_TYPES[3] = {AssessmentType::INDIVIDUAL, AssessmentType::JOINT,
+                                         AssessmentType::SOLE_PROPRIETOR};
+    for (AssessmentType type : ALL_TYPES) {
+        // Every threshold and its neighbours, the non-finite values, and an odd
+        // count so the SSE2 and AVX2 scalar tails run too
+        const TaxSchedule& schedule = scheduleFor(type);
+        std::vector<double> incomes = {0.0, -0.0, -1000.0, 1e15, std::numeric_limits<double>::quiet_NaN(),
+                                       std::numeric_limits<double>::infinity(),
+                                       -std::numeric_limits<double>::infinity()};
+        for (int k = 0; k < schedule.count; k++) {
+            incomes.push_back(schedule.thresholds[k]);
+            incomes.push_back(std::nextafter(schedule.thresholds[k], -1e300));
+            incomes.push_back(std::nextafter(schedule.thresholds[k], 1e300));
+            incomes.push_back(schedule.thresholds[k] + 0.5);
+        }
+        if (incomes.size() % 4 == 0) {
+            incomes.push_back(123456.78);
+        }
+
+        // Each kernel writes over a poisoned buffer, so a skipped lane cannot pass
+        std::vector<double> taxes(incomes.size());
+        auto matchesScalar = [&](void (*kernel)(const TaxSchedule&, const double*, double*, std::size_t)) {
+            std::fill(taxes.begin(), taxes.end(), -7.0);
+            kernel(schedule, incomes.data(), taxes.data(), incomes.size());
+            bool same = true;
+            for (std::size_t i = 0; i < incomes.size(); i++) {
+                same = same && sameTax(taxes[i], evaluateTax(type, incomes[i]));
+            }
+            return same;
+        };
+        CHECK(matchesScalar(calculateTaxesScalar));
+        CHECK(matchesScalar(calculateTaxes));
+#ifdef TAX_KERNEL_X86
+        if (__builtin_cpu_supports("sse2")) {
+            CHECK(matchesScalar(calculateTaxesSSE2));
+        }
+        if (__builtin_cpu_supports("avx2")) {
+            CHECK(matchesScalar(calculateTaxesAVX2));
+        }
+#endif
+        CHECK(taxes[4] != taxes[4]);
+        CHECK(taxes[5] == std::numeric_limits<double>::infinity());
+    }
+}
+
+void testBatchMatchesCalculator() {
+    const AssessmentType ALL_TYPES[3] = {AssessmentType::INDIVIDUAL, AssessmentType::JOINT,
+                                         AssessmentType::SOLE_PROPRIETOR};
+    const char* CATEGORIES[3] = {"Medical", "Education", "Lifestyle"};
+    for (ArithmeticMode mode : {ArithmeticMode::FLOATING_POINT, ArithmeticMode::FIXED_POINT}) {
+        // Amounts in sen from a fixed linear congruential sequence, so every run sees the same data
+        std::uint32_t state = 12345;
+        auto nextAmount = [&state](std::uint32_t range) {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<double>(state % range) / 100.0;
+        };
+
+        const int TAXPAYERS = 200;
+        TaxpayerBatch batch(mode);
+        std::vector<TaxCalculator> calculators;
+        calculators.reserve(TAXPAYERS);
+        for (int t = 0; t < TAXPAYERS; t++) {
+            AssessmentType type = ALL_TYPES[t % 3];
+            batch.addTaxpayer("Taxpayer", "900101-14-5678", type, 0);
+            calculators.emplace_back("Taxpayer", "900101-14-5678", type, mode);
+            for (int k = 0; k < t % 5; k++) {
+                double amount = nextAmount(50000000);
+                batch.addIncomeSource(amount);
+                calculators.back().addIncomeSource("Salary", amount);
+            }
+            for (int k = 0; k < t % 4; k++) {
+                double amount = nextAmount(2000000);
+                batch.addExpense(CATEGORIES[k % 3], amount);
+                calculators.back().addExpense(CATEGORIES[k % 3], "Receipt", amount);
+            }
+        }
+        CHECK(!batch.addExpense("Travel", 100));
+
+        TaxpayerBatch::Results results;
+        batch.calculateTaxes(results);
+        bool same = batch.size() == calculators.size();
+        for (std::size_t i = 0; same && i < batch.size(); i++) {
+            const TaxCalculator& calculator = calculators[i];
+            same = results.totalIncome[i] == calculator.calculateTotalIncome() &&
+                   results.totalDeductions[i] == calculator.calculateTotalDeductions() &&
+                   results.taxableIncome[i] == calculator.calculateTaxableIncome() &&
+                   results.tax[i] == calculator.calculateTax();
+        }
+        CHECK(same);
+    }
+}
+
+void testCalculatorTotals() {
+    // Removing or updating an entry leaves the totals a fresh sum would give
+    TaxCalculator calculator("A", "1", AssessmentType::INDIVIDUAL);
+    calculator.addIncomeSource("Salary", 0.1);
+    calculator.addIncomeSource("Bonus", 0.2);
+    calculator.addIncomeSource("Rental", 0.1);
+    CHECK(calculator.removeIncomeSource(2));
+    CHECK(calculator.calculateTotalIncome() == 0.1 + 0.2);
+    CHECK(calculator.removeIncomeSource(0));
+    CHECK(calculator.calculateTotalIncome() == 0.2);
+    CHECK(calculator.updateIncomeSource(0, 0.7));
+    CHECK(calculator.calculateTotalIncome() == 0.7);
+
+    calculator.addExpense(ExpenseCategory::MEDICAL, "Clinic", 0.1);
+    calculator.addExpense(ExpenseCategory::MEDICAL, "Dentist", 0.2);
+    CHECK(calculator.updateExpense(0, 0.3));
+    CHECK(calculator.removeExpense(1));
+    CHECK(calculator.calculateTotalDeductions() == 0.3);
+    CHECK(calculator.calculateTaxableIncome() == 0.7 - 0.3);
+
+    // A saturated sen total comes back once the entry that overflowed it is gone
+    TaxCalculator fixed("A", "1", AssessmentType::INDIVIDUAL, ArithmeticMode::FIXED_POINT);
+    fixed.addIncomeSource("Salary", 1000);
+    for (int i = 0; i < 35; i++) {
+        fixed.addIncomeSource("Bonus", 1e12);
+    }
+    bool removed = true;
+    for (int i = 0; i < 35; i++) {
+        removed = fixed.removeIncomeSource(1) && removed;
+    }
+    CHECK(removed && fixed.calculateTotalIncome() == 1000);
+}
+
+void testParseCount() {
+    long count = 7;
+    CHECK(parseCount("16", count) && count == 16);
+    CHECK(parseCount("-1", count) && count == -1);
+    CHECK(!parseCount("abc", count) && !parseCount("4x", count) && !parseCount("", count));
+    CHECK(!parseCount(" 4", count) && !parseCount("99999999999999999999", count));
+    CHECK(count == -1);
+}
+
+void testIcKeys() {
+    CHECK(icKey("123456-34-4567") == 1123456344567ull);
+    CHECK(icKey("123456-34-4567") == icKey("123456344567"));
+    CHECK(icKey("012") != icKey("12"));
+    CHECK(icKey("999999999999999999") == 1999999999999999999ull);
+    // No digits, or too many: hashed, with the top bit set
+    CHECK(icKey("ABC") >> 63 == 1);
+    CHECK(icKey("1234567890123456789") >> 63 == 1);
+
+    ReportBuffer text;
+    text.appendUnsigned(icKey("ABC"));
+    CHECK(text.view().front() != '-');
+}
+
+void testResultsFile() {
+    // Ten rows in groups of four: two full groups and a short one whose type column needs padding
+    const char* PATH = "tax_tests_results.tcol";
+    const char* IC_NUMBERS[3] = {"012345-01-0001", "12345-01-0001", "ABC"};
+    std::vector<ResultRow> rows;
+    for (int i = 0; i < 10; i++) {
+        rows.push_back({icKey(IC_NUMBERS[i % 3]), static_cast<AssessmentType>(i % 3),
+                        1000.25 * i, 10.5 * i, 989.75 * i, 12.5 * i});
+    }
+    {
+        ResultsFileWriter writer(4);
+        CHECK(writer.open(PATH));
+        for (const ResultRow& row : rows) {
+            writer.append(row);
+        }
+        CHECK(writer.close());
+    }
+
+    {
+        ResultsFileReader reader;
+        CHECK(reader.open(PATH));
+        CHECK(reader.rowCount() == rows.size());
+        CHECK(reader.rowGroupCount() == 3);
+        std::size_t next = 0;
+        bool same = true;
+        for (std::size_t g = 0; g < reader.rowGroupCount(); g++) {
+            const ResultRowGroup& group = reader.rowGroup(g);
+            for (std::size_t i = 0; i < group.rows && next < rows.size(); i++, next++) {
+                const ResultRow& row = rows[next];
+                double rate = row.totalIncome > 0 ? row.tax / row.totalIncome : 0;
+                same = same && group.icKeys[i] == row.icKey && group.types[i] == static_cast<std::uint8_t>(row.type) &&
+                       group.totalIncome[i] == row.totalIncome && group.totalDeductions[i] == row.totalDeductions &&
+                       group.taxableIncome[i] == row.taxableIncome && group.tax[i] == row.tax &&
+                       group.effectiveRate[i] == rate;
+            }
+        }
+        CHECK(same && next == rows.size());
+        CHECK(reader.rowGroup(0).icKeys[0] == 1012345010001ull);
+        CHECK(reader.rowGroup(0).icKeys[0] != reader.rowGroup(0).icKeys[1]);
+    }
+
+    // A header that promises more rows than the groups hold is rejected
+    std::FILE* file = std::fopen(PATH, "r+b");
+    CHECK(file != nullptr);
+    if (file != nullptr) {
+        std::uint64_t rowCount = rows.size() + 1;
+        CHECK(std::fseek(file, offsetof(ResultsFileHeader, rowCount), SEEK_SET) == 0);
+        CHECK(std::fwrite(&rowCount, sizeof(rowCount), 1, file) == 1);
+        std::fclose(file);
+        ResultsFileReader reader;
+        CHECK(!reader.open(PATH));
+    }
+    std::remove(PATH);
+}
+
+void testRings() {
+    // One producer, one consumer: every item arrives, in order, through a ring much smaller than the stream
+    const std::uint64_t ITEMS = 200000;
+    SpscRing<std::uint64_t> spsc(8);
+    std::thread producer([&] {
+        for (std::uint64_t i = 0; i < ITEMS; i++) {
+            spsc.push(i);
+        }
+    });
+    bool inOrder = true;
+    for (std::uint64_t i = 0; i < ITEMS; i++) {
+        inOrder = spsc.pop() == i && inOrder;
+    }
+    producer.join();
+    std::uint64_t item;
+    CHECK(inOrder);
+    CHECK(!spsc.tryPop(item));
+
+    // Several producers and consumers: every item arrives exactly once, and each
+    // consumer sees any one producer's items in the order they were pushed.
+    // Items are producer * PER_PRODUCER + i + 1; 0 tells a consumer to stop.
+    const unsigned PRODUCERS = 4, CONSUMERS = 4;
+    const std::uint64_t PER_PRODUCER = 50000;
+    MpmcRing<std::uint64_t> mpmc(16);
+    std::vector<std::vector<std::uint64_t>> received(CONSUMERS);
+    std::vector<std::thread> threads;
+    for (unsigned c = 0; c < CONSUMERS; c++) {
+        threads.emplace_back([&mpmc, &received, c] {
+            while (std::uint64_t value = mpmc.pop()) {
+                received[c].push_back(value);
+            }
+        });
+    }
+    for (unsigned p = 0; p < PRODUCERS; p++) {
+        threads.emplace_back([&mpmc, p] {
+            for (std::uint64_t i = 0; i < PER_PRODUCER; i++) {
+                mpmc.push(p * PER_PRODUCER + i + 1);
+            }
+        });
+    }
+    for (unsigned p = 0; p < PRODUCERS; p++) {
+        threads[CONSUMERS + p].join();
+    }
+    for (unsigned c = 0; c < CONSUMERS; c++) {
+        mpmc.push(0);
+    }
+    for (unsigned c = 0; c < CONSUMERS; c++) {
+        threads[c].join();
+    }
+
+    std::vector<std::uint8_t> seen(PRODUCERS * PER_PRODUCER + 1, 0);
+    bool once = true;
+    inOrder = true;
+    for (const auto& values : received) {
+        std::vector<std::uint64_t> last(PRODUCERS, 0);
+        for (std::uint64_t value : values) {
+            std::uint64_t p = (value - 1) / PER_PRODUCER;
+            inOrder = inOrder && value > last[p];
+            last[p] = value;
+            once = once && seen[value] == 0;
+            seen[value] = 1;
+        }
+    }
+    std::size_t total = 0;
+    for (std::size_t i = 1; i < seen.size(); i++) {
+        total += seen[i];
+    }
+    CHECK(once && total == PRODUCERS * PER_PRODUCER);
+    CHECK(inOrder);
+    CHECK(!mpmc.tryPop(item));
+}
+
+struct CountingOptions {
+    unsigned threads;
+    std::size_t chunkSize;
+};
+
+// Parses one number per line
+struct CountingChunk : PipelineChunk {
+    struct Scratch {
+        long chunks = 0;
+    };
+    explicit CountingChunk(const CountingOptions&) {}
+    std::vector<long> values;
+};
+
+void testChunkPipeline() {
+    // A header, then the numbers 1..LINES with a blank line after every 17th
+    const long LINES = 5000;
+    std::string text = "name,value\n";
+    std::vector<long> expectedLineNumbers;
+    long lineNumber = 1;
+    for (long i = 1; i <= LINES; i++) {
+        text.append(std::to_string(i)).append("\n");
+        expectedLineNumbers.push_back(++lineNumber);
+        if (i % 17 == 0) {
+            text.append("\n");
+            ++lineNumber;
+        }
+    }
+
+    for (unsigned threads : {1u, 4u}) {
+        std::vector<long> values, lineNumbers;
+        std::size_t nextSequence = 0;
+        bool sequential = true;
+        runChunkPipeline<CountingChunk>(
+            text, CountingOptions{threads, 7},
+            [](CountingChunk& chunk, CountingChunk::Scratch& scratch) {
+                // Hold back every third chunk so they finish out of order
+                if (chunk.sequence % 3 == 0) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+                chunk.values.clear();
+                for (std::string_view line : chunk.lines) {
+                    long value = 0;
+                    std::from_chars(line.data(), line.data() + line.size(), value);
+                    chunk.values.push_back(value);
+                }
+                ++scratch.chunks;
+            },
+            [&](CountingChunk& chunk) {
+                sequential = sequential && chunk.sequence == nextSequence++;
+                values.insert(values.end(), chunk.values.begin(), chunk.values.end());
+                lineNumbers.insert(lineNumbers.end(), chunk.lineNumbers.begin(), chunk.lineNumbers.end());
+            });
+
+        bool complete = static_cast<long>(values.size()) == LINES;
+        for (long i = 0; complete && i < LINES; i++) {
+            complete = values[i] == i + 1;
+        }
+        CHECK(sequential);
+        CHECK(complete);
+        CHECK(lineNumbers == expectedLineNumbers);
+    }
+}
+
+void testFixedPointLimits() {
+    // Sums beyond the sen range saturate instead of wrapping
+    TaxpayerBatch batch(ArithmeticMode::FIXED_POINT);
+    TaxCalculator calculator("A", "1", AssessmentType::INDIVIDUAL, ArithmeticMode::FIXED_POINT);
+    batch.addTaxpayer("A", "1", AssessmentType::INDIVIDUAL, 0);
+    for (int i = 0; i < 35; i++) {
+        batch.addIncomeSource(1e12);
+        calculator.addIncomeSource("Salary", 1e12);
+    }
+    TaxpayerBatch::Results results;
+    batch.calculateTaxes(results);
+    CHECK(results.totalIncome[0] == toRinggit(SEN_LIMIT));
+    CHECK(results.tax[0] > 0 && results.tax[0] < results.totalIncome[0]);
+    CHECK(calculator.calculateTax() == results.tax[0]);
+    CHECK(evaluateTaxSen(AssessmentType::JOINT, INT64_MAX) == evaluateTaxSen(AssessmentType::JOINT, SEN_LIMIT));
+    CHECK(evaluateTaxSen(AssessmentType::JOINT, INT64_MIN) == evaluateTaxSen(AssessmentType::JOINT, -SEN_LIMIT));
+}
+
+#ifdef TAX_DAEMON_SUPPORTED
+// Replies to every request with a line much longer than the request
+struct EchoHandler {
+    static const std::size_t REPLY_LENGTH = 32;
+
+    void operator()(std::string_view, ReportBuffer& reply) {
+        reply.append("OK 0123456789abcdef0123456789ab\n");
+    }
+};
+
+void testDaemonPipelining() {
+    // SIGTERM stays pending for the server's signalfd instead of killing the process
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGTERM);
+    sigset_t previousSignals;
+    sigprocmask(SIG_BLOCK, &signals, &previousSignals);
+
+    const std::string socketPath = "/tmp/tax_tests_" + std::to_string(getpid()) + ".sock";
+    EchoHandler handler;
+    int served = 0;
+    std::thread server([&] {
+        served = serveUnixSocket(socketPath, handler);
+    });
+
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    int client = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    bool connected = false;
+    for (int attempt = 0; attempt < 200 && !connected; attempt++) {
+        connected = connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0;
+        if (!connected) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    CHECK(connected);
+
+    // More than MAX_PENDING_REPLY of replies to requests that all fit in the
+    // server's input buffer, with the sending side left open
+    const std::size_t REQUESTS = 80000;
+    std::string requests;
+    for (std::size_t i = 0; i < REQUESTS; i++) {
+        requests.append("XX\n");
+    }
+    CHECK(REQUESTS * EchoHandler::REPLY_LENGTH > MAX_PENDING_REPLY);
+    timeval timeout = {5, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    std::thread sender([&] {
+        std::size_t sent = 0;
+        while (connected && sent < requests.size()) {
+            ssize_t count = send(client, requests.data() + sent, requests.size() - sent, MSG_NOSIGNAL);
+            if (count <= 0) {
+                break;
+            }
+            sent += static_cast<std::size_t>(count);
+        }
+    });
+    std::size_t replyBytes = 0;
+    char buffer[65536];
+    while (connected && replyBytes < REQUESTS * EchoHandler::REPLY_LENGTH) {
+        ssize_t count = recv(client, buffer, sizeof(buffer), 0);
+        if (count <= 0) {
+            break; // timed out: the server stalled
+        }
+        replyBytes += static_cast<std::size_t>(count);
+    }
+    CHECK(replyBytes == REQUESTS * EchoHandler::REPLY_LENGTH);
+    sender.join();
+    close(client);
+
+    kill(getpid(), SIGTERM);
+    server.join();
+    CHECK(served == 0);
+    sigprocmask(SIG_SETMASK, &previousSignals, nullptr);
+}
+#endif
+
+int main() {
+    testReportBuffer();
+    testCivilDates();
+    testReliefCapping();
+    testTaxKernels();
+    testBatchMatchesCalculator();
+    testCalculatorTotals();
+    testParseCount();
+    testIcKeys();
+    testResultsFile();
+    testRings();
+    testChunkPipeline();
+    testReliefSplit();
+    testIncomeGrid();
+    testFixedPointLimits();
+#ifdef TAX_DAEMON_SUPPORTED
+    testDaemonPipelining();
+#endif
+
+    std::cout << checkCount - failureCount << " of " << checkCount << " checks passed.\n";
+    return failureCount == 0 ? 0 : 1;
+}
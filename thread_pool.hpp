@@ -0,0 +1,181 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool with one task deque per worker.
+// A worker pops from the back of its own deque and, when that is empty,
+// steals from the front of the others. parallelFor() splits a range into
+// chunks (always on the same boundaries), spreads them over the deques and
+// helps run them until all are done, so results written by index come out
+// in a deterministic order.
+class WorkStealingPool {
+public:
+    // threadCount includes the calling thread; 0 means one per hardware thread
+    explicit WorkStealingPool(unsigned threadCount = 0) : queuedTasks(0), stopping(false) {
+        if (threadCount == 0) {
+            threadCount = std::thread::hardware_concurrency();
+        }
+        if (threadCount == 0) {
+            threadCount = 1;
+        }
+        for (unsigned i = 0; i < threadCount; i++) {
+            queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue));
+        }
+        // Queue 0 belongs to the thread calling parallelFor
+        for (unsigned i = 1; i < threadCount; i++) {
+            workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wakeCondition.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const {
+        return static_cast<unsigned>(queues.size());
+    }
+
+    // Runs body(begin, end) over [0, count) in chunks of at most chunkSize
+    // and returns when every chunk has finished.
+    template <class Body>
+    void parallelFor(std::size_t count, std::size_t chunkSize, Body body) {
+        if (count == 0) {
+            return;
+        }
+        if (chunkSize == 0) {
+            chunkSize = 1;
+        }
+        std::size_t chunks = (count + chunkSize - 1) / chunkSize;
+        if (chunks == 1 || queues.size() == 1) {
+            // Same chunk boundaries as the parallel path, run in order on this thread
+            for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+                body(begin, begin + chunkSize < count ? begin + chunkSize : count);
+            }
+            return;
+        }
+
+        Latch latch(chunks);
+        {
+            // Count the tasks before they become visible so idle workers never miss them
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            queuedTasks.fetch_add(chunks);
+        }
+        for (std::size_t c = 0; c < chunks; c++) {
+            std::size_t begin = c * chunkSize;
+            std::size_t end = begin + chunkSize < count ? begin + chunkSize : count;
+            WorkerQueue& queue = *queues[c % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.tasks.push_back([&body, &latch, begin, end] {
+                body(begin, end);
+                latch.countDown();
+            });
+        }
+        wakeCondition.notify_all();
+
+        // Help out instead of idling, then wait for chunks still running elsewhere
+        std::function<void()> task;
+        while (!latch.done() && takeTask(0, task)) {
+            task();
+        }
+        latch.wait();
+    }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    struct Latch {
+        explicit Latch(std::size_t count) : remaining(count) {}
+
+        void countDown() {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--remaining == 0) {
+                condition.notify_all();
+            }
+        }
+
+        bool done() {
+            std::lock_guard<std::mutex> lock(mutex);
+            return remaining == 0;
+        }
+
+        void wait() {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait(lock, [this] { return remaining == 0; });
+        }
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::size_t remaining;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<std::size_t> queuedTasks;
+    std::mutex wakeMutex;
+    std::condition_variable wakeCondition;
+    bool stopping;
+
+    // Own deque first (newest task), then steal the oldest task from the others
+    bool takeTask(unsigned self, std::function<void()>& task) {
+        {
+            WorkerQueue& own = *queues[self];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                queuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        for (std::size_t i = 1; i < queues.size(); i++) {
+            WorkerQueue& victim = *queues[(self + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                queuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void workerLoop(unsigned self) {
+        std::function<void()> task;
+        while (true) {
+            if (takeTask(self, task)) {
+                task();
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wakeCondition.wait(lock, [this] { return stopping || queuedTasks.load() > 0; });
+            if (stopping) {
+                return;
+            }
+        }
+    }
+};
+
+#endif